@@ -0,0 +1,185 @@
+// moon_cooker <asset directory> <output archive>
+// packs every file below the asset directory into one .mpak archive (see moon/asset/asset_archive_format.h).
+// images are decoded here so the runtime only uploads them, shaders and everything else are stored as is
+
+#include "moon/asset/asset_archive_format.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct cooked_asset
+{
+    std::string key;
+    moon::asset_archive_entry entry {};
+    std::vector<uint8_t> data;
+};
+
+static bool read_file(const fs::path& path, std::vector<uint8_t>& out)
+{
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    if (!in)
+        return false;
+
+    out.resize((size_t)fs::file_size(path));
+    in.read((char*)out.data(), (std::streamsize)out.size());
+    return (bool)in;
+}
+
+static bool is_image(const fs::path& path)
+{
+    const std::string ext = path.extension().string();
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".tga" || ext == ".bmp";
+}
+
+static bool cook_image(const fs::path& path, cooked_asset& asset)
+{
+    // same conventions as opengl_texture2d: bottom row first, grey images expanded to rgba
+    stbi_set_flip_vertically_on_load(true);
+
+    int width, height, channels;
+    int desired_channels = 0;
+    if (stbi_info(path.string().c_str(), &width, &height, &channels) && channels != 3)
+        desired_channels = 4;
+
+    stbi_uc* pixels = stbi_load(path.string().c_str(), &width, &height, &channels, desired_channels);
+    if (!pixels)
+    {
+        std::fprintf(stderr, "failed to decode %s: %s\n", path.string().c_str(), stbi_failure_reason());
+        return false;
+    }
+    if (desired_channels)
+        channels = desired_channels;
+
+    asset.entry.type = moon::asset_type::texture;
+    asset.entry.width = (uint32_t)width;
+    asset.entry.height = (uint32_t)height;
+    asset.entry.channels = (uint32_t)channels;
+    asset.data.assign(pixels, pixels + (size_t)width * height * channels);
+
+    stbi_image_free(pixels);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::fprintf(stderr, "usage: moon_cooker <asset directory> <output archive>\n");
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    const fs::path asset_dir = fs::path(argv[1]).lexically_normal();
+    const fs::path output = argv[2];
+    if (!fs::is_directory(asset_dir))
+    {
+        std::fprintf(stderr, "%s is not a directory\n", asset_dir.string().c_str());
+        return 1;
+    }
+
+    // keys are relative to the directory containing the assets, which is what the runtime sees as its working directory
+    const fs::path key_root = asset_dir.has_filename() ? asset_dir.parent_path() : asset_dir.parent_path().parent_path();
+
+    std::vector<cooked_asset> assets;
+    uint64_t source_bytes = 0;
+    for (const auto& dir_entry : fs::recursive_directory_iterator(asset_dir))
+    {
+        if (!dir_entry.is_regular_file())
+            continue;
+
+        const fs::path& path = dir_entry.path();
+        cooked_asset asset;
+        asset.key = fs::relative(path, key_root).generic_string();
+        source_bytes += dir_entry.file_size();
+
+        bool cooked;
+        if (is_image(path))
+        {
+            cooked = cook_image(path, asset);
+        }
+        else
+        {
+            asset.entry.type = path.extension() == ".glsl" ? moon::asset_type::shader : moon::asset_type::raw;
+            cooked = read_file(path, asset.data);
+        }
+
+        if (!cooked)
+        {
+            std::fprintf(stderr, "failed to cook %s\n", path.string().c_str());
+            return 1;
+        }
+
+        asset.entry.path_hash = moon::hash_asset_path(asset.key);
+        asset.entry.size = asset.data.size();
+        assets.push_back(std::move(asset));
+    }
+
+    std::ranges::sort(assets, [](const cooked_asset& a, const cooked_asset& b) { return a.entry.path_hash < b.entry.path_hash; });
+    for (size_t i = 1; i < assets.size(); i++)
+    {
+        if (assets[i].entry.path_hash == assets[i - 1].entry.path_hash)
+        {
+            std::fprintf(stderr, "hash collision between %s and %s, rename one of them\n", assets[i - 1].key.c_str(), assets[i].key.c_str());
+            return 1;
+        }
+    }
+
+    if (output.has_parent_path())
+        fs::create_directories(output.parent_path());
+
+    std::ofstream out(output, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        std::fprintf(stderr, "could not open %s for writing\n", output.string().c_str());
+        return 1;
+    }
+
+    const auto align = [](uint64_t offset) { return (offset + moon::asset_archive_alignment - 1) & ~(moon::asset_archive_alignment - 1); };
+    const char padding[moon::asset_archive_alignment] = {};
+
+    moon::asset_archive_header header { moon::asset_archive_magic, moon::asset_archive_version, assets.size(), 0 };
+    out.write((const char*)&header, sizeof(header));
+
+    uint64_t offset = sizeof(header);
+    for (auto& asset : assets)
+    {
+        const uint64_t aligned = align(offset);
+        out.write(padding, (std::streamsize)(aligned - offset));
+        asset.entry.offset = aligned;
+        out.write((const char*)asset.data.data(), (std::streamsize)asset.data.size());
+        offset = aligned + asset.data.size();
+    }
+
+    header.toc_offset = align(offset);
+    out.write(padding, (std::streamsize)(header.toc_offset - offset));
+    for (const auto& asset : assets)
+        out.write((const char*)&asset.entry, sizeof(asset.entry));
+
+    out.seekp(0);
+    out.write((const char*)&header, sizeof(header));
+    out.close();
+
+    if (!out)
+    {
+        std::fprintf(stderr, "failed writing %s\n", output.string().c_str());
+        return 1;
+    }
+
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("cooked %zu assets from %s into %s: %.2f MB source, %.2f MB packed, %.1f ms\n",
+        assets.size(), asset_dir.string().c_str(), output.string().c_str(),
+        (double)source_bytes / (1024.0 * 1024.0), (double)(header.toc_offset + assets.size() * sizeof(moon::asset_archive_entry)) / (1024.0 * 1024.0), ms);
+    return 0;
+}
@@ -0,0 +1,10 @@
+// per-frame camera data, filled once per scene by renderer::set_camera; mirrors camera_uniforms
+
+layout(std140, binding = 0) uniform Camera
+{
+    mat4 u_View;
+    mat4 u_Projection;
+    mat4 u_VP;
+    vec4 u_Viewport; // x, y, width, height
+    float u_Time;
+};
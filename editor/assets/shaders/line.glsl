@@ -0,0 +1,28 @@
+// batched line segments
+
+#type vertex
+#version 460 core
+
+layout (location = 0) in vec3 a_Position;
+layout (location = 1) in vec4 a_Color;
+
+#include "include/camera.glsl"
+
+out vec4 v_Color;
+
+void main()
+{
+    v_Color = a_Color;
+    gl_Position = u_VP * vec4(a_Position, 1.0);
+}
+
+#type fragment
+#version 460 core
+layout(location = 0) out vec4 FragColor;
+
+in vec4 v_Color;
+
+void main()
+{
+    FragColor = v_Color;
+}
@@ -1,4 +1,5 @@
 // basic texture shader
+// COLOR_ONLY: for batches that only use the white texture, skips sampling
 
 #type vertex
 #version 460 core
@@ -9,7 +10,7 @@ layout (location = 2) in vec2 a_TexCoord;
 layout (location = 3) in float a_TexIndex;
 layout (location = 4) in float a_TilingFactor;
 
-uniform mat4 u_VP = mat4(1.0);
+#include "include/camera.glsl"
 
 out vec4 v_Color;
 out vec2 v_TexCoord;
@@ -39,6 +40,7 @@ uniform sampler2D u_Textures[32];
 void main()
 {
     vec4 texColor = v_Color;
+#ifndef COLOR_ONLY
     switch(int(v_TexIndex))
     {
         case 0: texColor *= texture(u_Textures[0], v_TexCoord * v_TilingFactor); break;
@@ -74,5 +76,6 @@ void main()
         case 30: texColor *= texture(u_Textures[30], v_TexCoord * v_TilingFactor); break;
         case 31: texColor *= texture(u_Textures[31], v_TexCoord * v_TilingFactor); break;
     }
+#endif
     FragColor = texColor;
 }
@@ -22,13 +22,19 @@ namespace moon
         fb_spec.height = 720;
         m_framebuffer_ = framebuffer::create(fb_spec);
 
-        m_active_scene_ = create_ref<scene>();
+        m_editor_scene_ = create_ref<scene>();
+        m_active_scene_ = m_editor_scene_;
 
-        m_square_entity_ = m_active_scene_->create_entity("Square Entity");
+        m_square_entity_ = m_editor_scene_->create_entity("Square Entity");
         m_square_entity_.add_component<sprite_renderer_component>(glm::vec4{ 0, 1, 0, 1 });
 
-        m_camera_entity_ = m_active_scene_->create_entity("Camera");
+        m_camera_entity_ = m_editor_scene_->create_entity("Camera");
         m_camera_entity_.add_component<camera_component>(glm::ortho(-16.0f, 16.0f, -9.0f, 9.0f, -1.0f, 1.0f));
+
+        // only redraw on input, edits and play mode, so an idle editor doesn't pin a core and the gpu
+        application::get().set_on_demand_rendering(true);
+        // edited shaders and textures show up without restarting
+        asset_watcher::set_enabled(true);
     }
 
     void editor_layer::on_detach()
@@ -44,6 +50,10 @@ namespace moon
         if (m_viewport_focused_)
             m_camera_controller_.on_update(ts);
 
+        // the runtime scene animates every frame, and held keys move the camera without producing new events
+        if (m_scene_state_ == scene_state::play || (m_viewport_focused_ && input::get_snapshot().keys_down.any()))
+            application::get().request_redraw();
+
         renderer2d::reset_stats();
         m_framebuffer_->bind();
         render_command::set_clear_color({0.1f, 0.1f, 0.1f, 1.0f } );
@@ -107,6 +117,16 @@ namespace moon
                 ImGui::EndMenu();
             }
 
+            if (ImGui::BeginMenu("Scene"))
+            {
+                if (ImGui::MenuItem("Play", "", false, m_scene_state_ == scene_state::edit))
+                    on_scene_play();
+                if (ImGui::MenuItem("Stop", "", false, m_scene_state_ == scene_state::play))
+                    on_scene_stop();
+
+                ImGui::EndMenu();
+            }
+
             ImGui::EndMenuBar();
         }
 
@@ -116,10 +136,15 @@ namespace moon
         ImGui::Text("Renderer2D Stats:");
         ImGui::Text("Draw Calls: %d", stats.draw_calls);
         ImGui::Text("Quads: %d", stats.quad_count);
+        ImGui::Text("Circles: %d", stats.circle_count);
+        ImGui::Text("Lines: %d", stats.line_count);
+        ImGui::Text("Glyphs: %d", stats.glyph_count);
+        ImGui::Text("Particles: %d", stats.particle_count);
         ImGui::Text("Vertices: %d", stats.get_total_vertex_count());
         ImGui::Text("Indices: %d", stats.get_total_index_count());
 
-        if (m_square_entity_)
+        // entity handles point at the authoring scene, which must not change while playing
+        if (m_square_entity_ && m_scene_state_ == scene_state::edit)
         {
             ImGui::Separator();
             auto& tag = m_square_entity_.get_component<tag_component>().tag;
@@ -159,4 +184,21 @@ namespace moon
     {
         m_camera_controller_.on_event(e);
     }
+
+    void editor_layer::on_scene_play()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        m_active_scene_ = scene::copy(m_editor_scene_);
+        m_scene_state_ = scene_state::play;
+    }
+
+    void editor_layer::on_scene_stop()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        // dropping the runtime copy discards everything that happened during play
+        m_active_scene_ = m_editor_scene_;
+        m_scene_state_ = scene_state::edit;
+    }
 }
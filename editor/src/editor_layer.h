@@ -20,12 +20,25 @@ namespace moon
 
         void on_event(event&) override;
 
+    private:
+        void on_scene_play();
+        void on_scene_stop();
+
     private:
         ref<vertex_array> m_square_va_;
         ref<shader> m_flat_color_shader_;
         ref<texture2d> m_checkerboard_texture_;
         ref<framebuffer> m_framebuffer_;
 
+        enum class scene_state
+        {
+            edit,
+            play
+        };
+        scene_state m_scene_state_ = scene_state::edit;
+
+        // authoring data; play mode runs on a copy in m_active_scene_
+        ref<scene> m_editor_scene_;
         ref<scene> m_active_scene_;
         entity m_square_entity_;
 
@@ -13,6 +13,7 @@
 #include "moon/events/application_event.h"
 #include "moon/events/key_event.h"
 #include "moon/events/mouse_event.h"
+#include "moon/events/event_queue.h"
 
 #include "moon/core/timestep.h"
 
@@ -30,12 +31,22 @@
 #include "moon/renderer/shader.h"
 #include "moon/renderer/camera.h"
 #include "moon/renderer/texture.h"
+#include "moon/renderer/texture_loader.h"
+#include "moon/renderer/texture_cache.h"
 #include "moon/renderer/subtexture2d.h"
+#include "moon/renderer/texture_atlas.h"
+#include "moon/renderer/font.h"
+#include "moon/renderer/particle_system.h"
 #include "moon/renderer/orthographic_camera_controller.h"
 
 #include "moon/scene/scene.h"
 #include "moon/scene/entity.h"
 #include "moon/scene/components.h"
+#include "moon/scene/scene_serializer.h"
+#include "moon/scene/scene_streamer.h"
+
+#include "moon/asset/asset_archive.h"
+#include "moon/asset/asset_watcher.h"
 
 //#ifndef MOON_IS_MONOLITHIC
 struct ImGuiContext;
@@ -0,0 +1,107 @@
+#include "moonpch.h"
+#include "asset_archive.h"
+
+#include "moon/core/mapped_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+namespace moon
+{
+    struct mounted_archive
+    {
+        std::string path;
+        mapped_file file;
+        const asset_archive_entry* entries = nullptr;
+        uint64_t entry_count = 0;
+    };
+
+    static std::vector<scope<mounted_archive>> s_archives;
+
+    bool asset_archive::mount(std::string_view path)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        auto archive = create_scope<mounted_archive>();
+        archive->path = path;
+        if (!archive->file.open(path))
+        {
+            MOON_CORE_ERROR("Could not open asset archive '{0}'", path);
+            return false;
+        }
+
+        const mapped_file& file = archive->file;
+        asset_archive_header header;
+        if (file.size() < sizeof(header))
+        {
+            MOON_CORE_ERROR("'{0}' is not an asset archive", path);
+            return false;
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+
+        if (header.magic != asset_archive_magic || header.version != asset_archive_version)
+        {
+            MOON_CORE_ERROR("'{0}' is not a compatible asset archive", path);
+            return false;
+        }
+
+        if (header.toc_offset % alignof(asset_archive_entry) != 0 || header.toc_offset > file.size()
+            || header.entry_count > (file.size() - header.toc_offset) / sizeof(asset_archive_entry))
+        {
+            MOON_CORE_ERROR("Asset archive '{0}' is truncated", path);
+            return false;
+        }
+
+        // the toc is read in place
+        archive->entries = reinterpret_cast<const asset_archive_entry*>(file.data() + header.toc_offset);
+        archive->entry_count = header.entry_count;
+
+        MOON_CORE_INFO("Mounted asset archive '{0}' ({1} assets, {2:.2f} MB)", path, archive->entry_count,
+            (double)file.size() / (1024.0 * 1024.0));
+
+        s_archives.push_back(std::move(archive));
+        return true;
+    }
+
+    void asset_archive::unmount_all()
+    {
+        s_archives.clear();
+    }
+
+    bool asset_archive::find(std::string_view path, packed_asset& out)
+    {
+        if (s_archives.empty())
+            return false;
+
+        const std::string normalized = std::filesystem::path(path).lexically_normal().generic_string();
+        const uint64_t hash = hash_asset_path(normalized);
+
+        for (auto it = s_archives.rbegin(); it != s_archives.rend(); ++it)
+        {
+            const mounted_archive& archive = **it;
+            const asset_archive_entry* end = archive.entries + archive.entry_count;
+            const asset_archive_entry* entry = std::lower_bound(archive.entries, end, hash,
+                [](const asset_archive_entry& e, uint64_t h) { return e.path_hash < h; });
+
+            if (entry == end || entry->path_hash != hash)
+                continue;
+
+            if (entry->offset > archive.file.size() || entry->size > archive.file.size() - entry->offset)
+            {
+                MOON_CORE_ERROR("Asset '{0}' lies outside of archive '{1}'", path, archive.path);
+                return false;
+            }
+
+            out.type = entry->type;
+            out.data = archive.file.data() + entry->offset;
+            out.size = entry->size;
+            out.width = entry->width;
+            out.height = entry->height;
+            out.channels = entry->channels;
+            return true;
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "moon/core/core.h"
+#include "moon/asset/asset_archive_format.h"
+
+#include <string_view>
+
+namespace moon
+{
+    /// An asset inside a mounted archive, data points into the mapping and stays valid until unmount_all
+    struct packed_asset
+    {
+        asset_type type = asset_type::raw;
+        const uint8_t* data = nullptr;
+        uint64_t size = 0;
+        uint32_t width = 0, height = 0, channels = 0;
+    };
+
+    /// Read-only access to archives produced by the cooker. Archives are memory mapped, so a lookup is a binary
+    /// search over the hash sorted table of contents and loading is a pointer into the mapping.
+    /// Loaders check here before falling back to loose files
+    class MOON_API asset_archive
+    {
+    public:
+        static bool mount(std::string_view path);
+        static void unmount_all();
+
+        /// Later mounts take precedence over earlier ones
+        static bool find(std::string_view path, packed_asset& out);
+    };
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+// shared between the engine and the cooker, keep this free of engine dependencies
+
+#include <cstdint>
+#include <string_view>
+
+namespace moon
+{
+    // .mpak layout, offsets are relative to the start of the file:
+    //   asset_archive_header
+    //   asset blobs, each starting on a 16 byte boundary
+    //   asset_archive_entry[entry_count], sorted by path_hash
+    inline constexpr uint32_t asset_archive_magic = 0x4B41504D; // "MPAK"
+    inline constexpr uint32_t asset_archive_version = 1;
+    inline constexpr uint64_t asset_archive_alignment = 16;
+
+    enum class asset_type : uint32_t
+    {
+        raw = 0,     // bytes of the source file
+        texture = 1, // decoded pixels, bottom row first, width * height * channels bytes
+        shader = 2   // glsl source
+    };
+
+    struct asset_archive_header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t entry_count;
+        uint64_t toc_offset;
+    };
+
+    struct asset_archive_entry
+    {
+        uint64_t path_hash;
+        uint64_t offset;
+        uint64_t size;
+        asset_type type;
+        uint32_t width, height, channels; // textures only
+    };
+
+    /// Assets are keyed by their path relative to the working directory, e.g. "assets/shaders/texture.glsl"
+    constexpr uint64_t hash_asset_path(std::string_view path)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (char c : path)
+        {
+            // windows style separators name the same asset
+            hash ^= (uint8_t)(c == '\\' ? '/' : c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+}
@@ -0,0 +1,303 @@
+#include "moonpch.h"
+#include "asset_watcher.h"
+
+#include "moon/asset/asset_archive.h"
+#include "moon/core/file_watcher.h"
+#include "moon/renderer/texture_loader.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+namespace moon
+{
+    using watch_clock = std::chrono::steady_clock;
+
+    struct watched_asset
+    {
+        std::string path; // as the loader got it
+        std::vector<std::weak_ptr<texture2d>> textures;
+        std::vector<std::weak_ptr<shader>> shaders;
+    };
+
+    struct asset_watcher_data
+    {
+        static constexpr uint32_t poll_timeout_ms = 100;
+        static constexpr size_t min_prune_size = 64;
+
+        // main thread only, by normalized absolute path
+        std::unordered_map<std::string, watched_asset> assets;
+        std::unordered_set<std::string> directories;
+        // assets whose handles all expired are swept once the map grows to this size
+        size_t prune_size = min_prune_size;
+
+        scope<file_watcher> watcher;
+        std::thread thread;
+        std::atomic<bool> stop = false;
+
+        // written by the watcher thread, time of the latest write per normalized path
+        std::mutex mutex;
+        std::unordered_map<std::string, watch_clock::time_point> changes;
+
+        float debounce = 0.1f;
+
+        asset_watcher_stats stats;
+    };
+
+    static asset_watcher_data* s_watcher = nullptr;
+
+    static std::string normalize_path(std::string_view path)
+    {
+        std::error_code ec;
+        std::filesystem::path absolute = std::filesystem::absolute(std::filesystem::path(path), ec);
+        return (ec ? std::filesystem::path(path) : absolute).lexically_normal().generic_string();
+    }
+
+    static void watcher_main()
+    {
+        std::vector<std::string> changed;
+        while (!s_watcher->stop)
+        {
+            changed.clear();
+            s_watcher->watcher->wait(changed, asset_watcher_data::poll_timeout_ms);
+            if (changed.empty())
+                continue;
+
+            const auto now = watch_clock::now();
+            std::lock_guard lock(s_watcher->mutex);
+            for (const auto& path : changed)
+                s_watcher->changes[std::filesystem::path(path).lexically_normal().generic_string()] = now;
+        }
+    }
+
+    static void watch_directory_of(const std::string& normalized_path)
+    {
+        std::string directory = std::filesystem::path(normalized_path).parent_path().generic_string();
+        if (s_watcher->directories.contains(directory))
+            return;
+
+        if (s_watcher->watcher->add_directory(directory))
+            s_watcher->directories.insert(std::move(directory));
+    }
+
+    static void prune_assets()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        std::erase_if(s_watcher->assets, [](const auto& entry)
+        {
+            const watched_asset& asset = entry.second;
+            return std::ranges::all_of(asset.textures, [](const auto& t) { return t.expired(); })
+                && std::ranges::all_of(asset.shaders, [](const auto& s) { return s.expired(); });
+        });
+
+        // doubling keeps the sweeps amortized constant per registration
+        s_watcher->prune_size = std::max(asset_watcher_data::min_prune_size, s_watcher->assets.size() * 2);
+    }
+
+    /// Drops expired handles and adds the new one once, so reloading the same asset doesn't grow the list
+    template<typename T>
+    static void add_handle(std::vector<std::weak_ptr<T>>& handles, const ref<T>& handle)
+    {
+        std::erase_if(handles, [](const std::weak_ptr<T>& h) { return h.expired(); });
+        if (std::ranges::none_of(handles, [&](const std::weak_ptr<T>& h) { return h.lock() == handle; }))
+            handles.push_back(handle);
+    }
+
+    static watched_asset* register_asset(std::string_view path)
+    {
+        if (!s_watcher)
+            return nullptr;
+
+        if (s_watcher->assets.size() >= s_watcher->prune_size)
+            prune_assets();
+
+        // packed assets take precedence over loose files, a reload would read the archive again
+        packed_asset packed;
+        std::error_code ec;
+        if (asset_archive::find(path, packed) || !std::filesystem::is_regular_file(std::filesystem::path(path), ec))
+            return nullptr;
+
+        std::string normalized = normalize_path(path);
+        auto [it, inserted] = s_watcher->assets.try_emplace(normalized);
+        if (inserted)
+        {
+            it->second.path = path;
+            if (s_watcher->watcher)
+                watch_directory_of(normalized);
+        }
+        return &it->second;
+    }
+
+    void asset_watcher::init()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        s_watcher = new asset_watcher_data;
+    }
+
+    void asset_watcher::shutdown()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        set_enabled(false);
+
+        delete s_watcher;
+        s_watcher = nullptr;
+    }
+
+    void asset_watcher::set_enabled(bool enabled)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        if (!s_watcher || enabled == is_enabled())
+            return;
+
+        if (enabled)
+        {
+            s_watcher->watcher = create_scope<file_watcher>();
+            for (const auto& [path, asset] : s_watcher->assets)
+                watch_directory_of(path);
+
+            s_watcher->stop = false;
+            s_watcher->thread = std::thread(watcher_main);
+            return;
+        }
+
+        s_watcher->stop = true;
+        s_watcher->thread.join();
+        s_watcher->watcher.reset();
+        s_watcher->directories.clear();
+
+        std::lock_guard lock(s_watcher->mutex);
+        s_watcher->changes.clear();
+    }
+
+    bool asset_watcher::is_enabled()
+    {
+        return s_watcher && s_watcher->watcher;
+    }
+
+    void asset_watcher::set_debounce(float seconds)
+    {
+        if (s_watcher)
+            s_watcher->debounce = std::max(seconds, 0.0f);
+    }
+
+    void asset_watcher::watch(const ref<texture2d>& texture, std::string_view path)
+    {
+        if (watched_asset* asset = register_asset(path))
+            add_handle(asset->textures, texture);
+    }
+
+    void asset_watcher::watch(const ref<shader>& shader, std::string_view path)
+    {
+        if (watched_asset* asset = register_asset(path))
+            add_handle(asset->shaders, shader);
+    }
+
+    static bool reload_asset(watched_asset& asset)
+    {
+        bool reloaded = false;
+        bool failed = false;
+
+        std::erase_if(asset.textures, [](const std::weak_ptr<texture2d>& t) { return t.expired(); });
+        for (const auto& weak_texture : asset.textures)
+        {
+            ref<texture2d> texture = weak_texture.lock();
+            // images decode on the loader's workers; dds files are uploaded as they are, so that is cheap here
+            if (asset.path.ends_with(".dds"))
+            {
+                if (texture->reload())
+                    reloaded = true;
+                else
+                    failed = true;
+            }
+            else
+            {
+                texture_loader::load(texture, asset.path);
+                reloaded = true;
+            }
+        }
+
+        std::erase_if(asset.shaders, [](const std::weak_ptr<shader>& s) { return s.expired(); });
+        for (const auto& weak_shader : asset.shaders)
+        {
+            ref<shader> shader = weak_shader.lock();
+            if (shader->reload())
+                reloaded = true;
+            else
+                failed = true;
+        }
+
+        if (failed)
+        {
+            MOON_CORE_ERROR("Failed to reload '{0}', keeping the previous version", asset.path);
+            s_watcher->stats.failed_reloads++;
+        }
+        if (reloaded)
+        {
+            MOON_CORE_INFO("Reloaded '{0}'", asset.path);
+            s_watcher->stats.reloads++;
+        }
+        return reloaded;
+    }
+
+    uint32_t asset_watcher::process_changes()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        if (!is_enabled())
+            return 0;
+
+        std::vector<std::string> settled;
+        {
+            const auto cutoff = watch_clock::now() - std::chrono::duration_cast<watch_clock::duration>(
+                std::chrono::duration<float>(s_watcher->debounce));
+
+            std::lock_guard lock(s_watcher->mutex);
+            for (auto it = s_watcher->changes.begin(); it != s_watcher->changes.end();)
+            {
+                if (it->second <= cutoff)
+                {
+                    settled.push_back(it->first);
+                    it = s_watcher->changes.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+        uint32_t reloaded = 0;
+        for (const auto& path : settled)
+        {
+            // other files in a watched directory
+            auto it = s_watcher->assets.find(path);
+            if (it == s_watcher->assets.end())
+                continue;
+
+            if (reload_asset(it->second))
+                reloaded++;
+
+            if (it->second.textures.empty() && it->second.shaders.empty())
+                s_watcher->assets.erase(it);
+        }
+
+        return reloaded;
+    }
+
+    asset_watcher_stats asset_watcher::get_stats()
+    {
+        if (!s_watcher)
+            return {};
+
+        asset_watcher_stats stats = s_watcher->stats;
+        stats.watched_files = (uint32_t)s_watcher->assets.size();
+        stats.watched_directories = (uint32_t)s_watcher->directories.size();
+        return stats;
+    }
+}
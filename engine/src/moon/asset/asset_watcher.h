@@ -0,0 +1,46 @@
+#pragma once
+
+#include "moon/core/core.h"
+#include "moon/renderer/shader.h"
+#include "moon/renderer/texture.h"
+
+#include <string_view>
+
+namespace moon
+{
+    struct asset_watcher_stats
+    {
+        uint32_t watched_files = 0;
+        uint32_t watched_directories = 0;
+
+        uint32_t reloads = 0;
+        uint32_t failed_reloads = 0;
+    };
+
+    /// Reloads shaders and textures in place when their files change, so the handles already handed out
+    /// pick up the new content. A background thread waits on a file_watcher; a change has to settle for the
+    /// debounce interval before process_changes reloads it, so an editor saving in several writes costs one
+    /// reload. Images are decoded on texture_loader's workers, shaders recompile on the main thread.
+    /// Loaders register what they load from disk; nothing is watched until hot reloading is enabled, and
+    /// registrations whose assets were all released are swept as new ones come in
+    class MOON_API asset_watcher
+    {
+    public:
+        static void init();
+        static void shutdown();
+
+        /// Starts or stops the watcher thread, registrations are kept either way
+        static void set_enabled(bool enabled);
+        [[nodiscard]] static bool is_enabled();
+        static void set_debounce(float seconds);
+
+        static void watch(const ref<texture2d>& texture, std::string_view path);
+        static void watch(const ref<shader>& shader, std::string_view path);
+
+        /// Reloads the assets whose files have settled, returns how many were reloaded.
+        /// Called once per frame by application
+        static uint32_t process_changes();
+
+        static asset_watcher_stats get_stats();
+    };
+}
@@ -3,6 +3,7 @@
 #include "application.h"
 
 #include "log.h"
+#include "input.h"
 #include "moon/events/application_event.h"
 #include "moon/events/event.h"
 
@@ -10,15 +11,23 @@
 
 #include "moon/renderer/renderer.h"
 #include "moon/renderer/render_command.h"
+#include "moon/renderer/texture_loader.h"
+#include "moon/asset/asset_archive.h"
+#include "moon/asset/asset_watcher.h"
 
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
+#include <cmath>
+#include <filesystem>
 #include <memory>
 
 namespace moon
 {
     application* application::s_instance = nullptr;
 
+    static constexpr uint32_t s_redraw_frames_per_event = 3;
+    static constexpr const char* s_cooked_asset_archive = "assets.mpak";
+
     application::application(std::string_view name)
     {
         MOON_PROFILE_FUNCTION();
@@ -26,6 +35,10 @@ namespace moon
         MOON_CORE_ASSERT(!s_instance, "Application already exists!");
         s_instance = this;
 
+        // cooked builds ship their assets packed, anything missing from the archive still loads from loose files
+        if (std::filesystem::exists(s_cooked_asset_archive))
+            asset_archive::mount(s_cooked_asset_archive);
+
         window_ = std::unique_ptr<window>(window::create(window_props(name)));
         window_->set_event_callback([&](event& e) { on_event(e); });
 
@@ -40,6 +53,7 @@ namespace moon
         MOON_PROFILE_FUNCTION();
 
         renderer::shutdown();
+        asset_archive::unmount_all();
     }
 
     void application::push_layer(layer* layer)
@@ -66,12 +80,55 @@ namespace moon
         {
             MOON_PROFILE_SCOPE("Run Loop");
 
+            // changes picked up while idling have to be shown
+            if (asset_watcher::process_changes() > 0)
+                request_redraw();
+
+            // pending texture loads keep the loop going until they have replaced their placeholders
+            if (on_demand_rendering_ && redraw_frames_ == 0 && !input_replayer_ && !texture_loader::has_pending())
+            {
+                {
+                    MOON_PROFILE_SCOPE("wait for events");
+                    window_->wait_events(idle_timeout_);
+                }
+
+                // the first frame after idling gets a near zero timestep instead of the whole idle period
+                last_frame_time_ = (float)glfwGetTime();
+                if (redraw_frames_ == 0)
+                    continue;
+            }
+            if (redraw_frames_ > 0)
+                redraw_frames_--;
+
             const auto time = (float)glfwGetTime(); // Should be Platform::GetTime
             timestep ts = time - last_frame_time_;
             last_frame_time_ = time;
 
+            if (input_replayer_)
+            {
+                // recorded events stand in for the live ones, which on_event dropped during the last poll
+                if (!input_replayer_->next_frame([this](event& e) { dispatch_event(e); }))
+                {
+                    finish_input_replay();
+                    break;
+                }
+                ts = input_replay_timestep_;
+            }
+            else if (input_recorder_)
+            {
+                input_recorder_->end_frame(ts);
+            }
+
+            // publish everything that arrived during the last poll
+            input::new_frame();
+
+            texture_loader::process_uploads();
+
             if (!minimized_)
             {
+                if (fixed_timestep_ > 0.0f)
+                    run_fixed_updates(ts);
+
                 {
                     MOON_PROFILE_SCOPE("layer_stack on_update");
 
@@ -91,7 +148,11 @@ namespace moon
                 m_imgui_layer_->end();
             }
 
+            frame_pacer_.wait();
             window_->on_update();
+
+            if (input_replayer_)
+                input_replayer_->add_frame_time(((float)glfwGetTime() - time) * 1000.0f);
         }
     }
 
@@ -99,10 +160,28 @@ namespace moon
     {
         MOON_PROFILE_FUNCTION();
 
+        if (input_replayer_ && e.is_in_category(EVENT_CATEGORY_INPUT))
+            return;
+
+        if (input_recorder_)
+            input_recorder_->record_event(e);
+
+        // imgui needs a couple of frames to settle hover and focus changes
+        if (on_demand_rendering_)
+            request_redraw(s_redraw_frames_per_event);
+
+        dispatch_event(e);
+    }
+
+    void application::dispatch_event(event& e)
+    {
         event_dispatcher dispatcher(e);
         dispatcher.dispatch<window_close_event>([&](window_close_event& wce) { return on_window_close(wce); });
         dispatcher.dispatch<window_resize_event>([&](window_resize_event& wre) { return on_window_resize(wre); });
 
+        // input state tracks the raw stream, before any layer can mark the event handled
+        input::on_event(e);
+
         for (auto it = layer_stack_.rbegin(); it != layer_stack_.rend(); ++it)
         {
             if (e.handled)
@@ -116,6 +195,85 @@ namespace moon
         running_ = false;
     }
 
+    void application::set_on_demand_rendering(bool enabled, float idle_timeout_seconds)
+    {
+        MOON_CORE_ASSERT(idle_timeout_seconds > 0.0f, "Idle timeout must be positive!");
+
+        on_demand_rendering_ = enabled;
+        idle_timeout_ = idle_timeout_seconds;
+        // draw the current state once before the first wait
+        request_redraw(s_redraw_frames_per_event);
+    }
+
+    void application::set_fixed_update_rate(float hz, uint32_t max_steps_per_frame)
+    {
+        MOON_CORE_ASSERT(hz >= 0.0f, "Fixed update rate can't be negative!");
+        MOON_CORE_ASSERT(max_steps_per_frame > 0, "Fixed update needs at least one step per frame!");
+
+        fixed_timestep_ = hz > 0.0f ? 1.0f / hz : 0.0f;
+        max_fixed_steps_ = max_steps_per_frame;
+        fixed_accumulator_ = 0.0f;
+        interpolation_alpha_ = 0.0f;
+    }
+
+    void application::run_fixed_updates(timestep ts)
+    {
+        MOON_PROFILE_SCOPE("layer_stack on_fixed_update");
+
+        // a frame longer than the step budget (debugger break, window drag) only contributes what can be simulated
+        fixed_accumulator_ += std::min((float)ts, fixed_timestep_ * (float)max_fixed_steps_);
+
+        uint32_t steps = 0;
+        while (fixed_accumulator_ >= fixed_timestep_ && steps < max_fixed_steps_)
+        {
+            for (layer* l : layer_stack_)
+                l->on_fixed_update(fixed_timestep_);
+
+            fixed_accumulator_ -= fixed_timestep_;
+            steps++;
+        }
+
+        // out of steps, drop whole steps rather than carrying the debt into the next frame
+        if (fixed_accumulator_ >= fixed_timestep_)
+            fixed_accumulator_ = std::fmod(fixed_accumulator_, fixed_timestep_);
+
+        interpolation_alpha_ = fixed_accumulator_ / fixed_timestep_;
+    }
+
+    bool application::start_input_recording(std::string_view filepath)
+    {
+        MOON_CORE_ASSERT(!input_replayer_, "Can't record input while replaying!");
+
+        auto recorder = create_scope<input_recorder>();
+        if (!recorder->open(filepath))
+            return false;
+
+        input_recorder_ = std::move(recorder);
+        return true;
+    }
+
+    bool application::start_input_replay(std::string_view filepath, float fixed_timestep)
+    {
+        MOON_CORE_ASSERT(!input_recorder_, "Can't replay input while recording!");
+        MOON_CORE_ASSERT(fixed_timestep > 0.0f, "Replay timestep must be positive!");
+
+        auto replayer = create_scope<input_replayer>();
+        if (!replayer->open(filepath))
+            return false;
+
+        input_replayer_ = std::move(replayer);
+        input_replay_path_ = filepath;
+        input_replay_timestep_ = fixed_timestep;
+        return true;
+    }
+
+    void application::finish_input_replay()
+    {
+        input_replayer_->report_frame_times(input_replay_path_ + ".frametimes.csv");
+        input_replayer_.reset();
+        running_ = false;
+    }
+
     bool application::on_window_close(window_close_event&)
     {
         running_ = false;
@@ -4,6 +4,8 @@
 #include "moon/core/core.h"
 #include "moon/core/layer.h"
 #include "moon/core/layer_stack.h"
+#include "moon/core/input_recorder.h"
+#include "moon/core/frame_pacer.h"
 #include "moon/imgui/imgui_layer.h"
 
 #include "moon/renderer/vertex_array.h"
@@ -28,8 +30,30 @@ namespace moon
 
         void close();
 
+        /// In on-demand mode the loop sleeps until an event arrives or a layer requests a redraw,
+        /// instead of rendering continuously. idle_timeout bounds each sleep
+        void set_on_demand_rendering(bool enabled, float idle_timeout_seconds = 0.5f);
+        [[nodiscard]] bool is_on_demand_rendering() const { return on_demand_rendering_; }
+        /// Keeps rendering for at least the next frame_count frames, call every frame while something animates
+        void request_redraw(uint32_t frame_count = 1) { redraw_frames_ = std::max(redraw_frames_, frame_count); }
+
+        /// Enables layer::on_fixed_update at hz steps per second, 0 disables it. A slow frame runs at most
+        /// max_steps_per_frame catch-up steps and drops the rest of its time, so the simulation can't spiral
+        void set_fixed_update_rate(float hz, uint32_t max_steps_per_frame = 5);
+        [[nodiscard]] float get_fixed_timestep() const { return fixed_timestep_; }
+        /// How far the current frame is between the last fixed update and the next one, in [0, 1)
+        [[nodiscard]] float get_interpolation_alpha() const { return interpolation_alpha_; }
+
+        /// Writes every frame's input and timestep to filepath until the application exits
+        bool start_input_recording(std::string_view filepath);
+        /// Drives the application from a recording with a fixed timestep, ignoring live input, then closes it.
+        /// Frame times are written to "<filepath>.frametimes.csv"
+        bool start_input_replay(std::string_view filepath, float fixed_timestep = 1.0f / 60.0f);
+
         inline static application& get() { return *s_instance; }
         inline window& get_window() { return *window_; }
+        /// Frame cap on top of the window's vsync mode, uncapped by default
+        inline frame_pacer& get_frame_pacer() { return frame_pacer_; }
 
         imgui_layer* get_imgui_layer() { return m_imgui_layer_; }
 
@@ -37,16 +61,35 @@ namespace moon
         bool on_window_close(window_close_event& e);
         bool on_window_resize(window_resize_event& e);
 
+        void run_fixed_updates(timestep ts);
+        void dispatch_event(event& e);
+        void finish_input_replay();
+
         scope<window> window_;
         imgui_layer* m_imgui_layer_;
         bool running_ = true;
         bool minimized_ = false;
 
         layer_stack layer_stack_;
+        frame_pacer frame_pacer_;
 
         static application* s_instance;
 
         float last_frame_time_ = 0.0f;
+
+        bool on_demand_rendering_ = false;
+        float idle_timeout_ = 0.5f;
+        uint32_t redraw_frames_ = 0;
+
+        float fixed_timestep_ = 0.0f;
+        uint32_t max_fixed_steps_ = 5;
+        float fixed_accumulator_ = 0.0f;
+        float interpolation_alpha_ = 0.0f;
+
+        scope<input_recorder> input_recorder_;
+        scope<input_replayer> input_replayer_;
+        std::string input_replay_path_;
+        float input_replay_timestep_ = 0.0f;
     };
 
     // to be defined in the client
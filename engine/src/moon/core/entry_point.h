@@ -6,7 +6,7 @@
 
 extern moon::application* moon::create_application();
 
-int main()
+int main(int argc, char** argv)
 {
     moon::log::init();
 
@@ -14,6 +14,16 @@ int main()
     auto app = moon::create_application();
     MOON_PROFILE_END_SESSION();
 
+    // --record-input=<file> captures the session, --replay-input=<file> plays one back for frame-time comparisons
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string_view arg = argv[i];
+        if (arg.starts_with("--record-input="))
+            app->start_input_recording(arg.substr(std::string_view("--record-input=").size()));
+        else if (arg.starts_with("--replay-input="))
+            app->start_input_replay(arg.substr(std::string_view("--replay-input=").size()));
+    }
+
     MOON_PROFILE_BEGIN_SESSION("Startup", "MoonProfile-Runtime.json");
     app->run();
     MOON_PROFILE_END_SESSION();
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "moon/core/core.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace moon
+{
+    /// Reports files that were written to inside watched directories. wait() blocks, so it belongs on a
+    /// dedicated thread; add_directory may be called from any thread meanwhile.
+    /// Implemented per platform: inotify on linux, polling modification times elsewhere
+    class MOON_API file_watcher
+    {
+    public:
+        file_watcher();
+        ~file_watcher();
+
+        file_watcher(const file_watcher&) = delete;
+        file_watcher& operator=(const file_watcher&) = delete;
+
+        /// Not recursive, adding a directory twice is harmless
+        bool add_directory(std::string_view directory);
+
+        /// Waits up to timeout_ms and appends the paths of files that finished a write or were moved in,
+        /// as directory / file name with directory as it was added. The same file may be reported repeatedly
+        void wait(std::vector<std::string>& out_changed, uint32_t timeout_ms);
+
+    private:
+        struct impl;
+        scope<impl> impl_;
+    };
+}
@@ -0,0 +1,75 @@
+#include "moonpch.h"
+#include "frame_pacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace moon
+{
+    static constexpr std::chrono::microseconds s_min_spin_margin { 250 };
+    static constexpr std::chrono::microseconds s_max_spin_margin { 4000 };
+
+    void frame_pacer::set_target_fps(float fps)
+    {
+        MOON_CORE_ASSERT(fps >= 0.0f, "Target fps can't be negative!");
+
+        target_fps_ = fps;
+        period_ = fps > 0.0f ? std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / fps)) : clock::duration {};
+        deadline_ = {};
+        reset_stats();
+    }
+
+    void frame_pacer::wait()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        if (period_ == clock::duration {})
+            return;
+
+        auto now = clock::now();
+        if (deadline_ == clock::time_point {})
+            deadline_ = now + period_;
+
+        if (now < deadline_)
+        {
+            const auto sleep_until = deadline_ - spin_margin_;
+            if (now < sleep_until)
+            {
+                std::this_thread::sleep_until(sleep_until);
+
+                // learn how late the os wakes us, so the spin covers it next time
+                const auto oversleep = clock::now() - sleep_until;
+                const auto wanted = std::chrono::duration_cast<clock::duration>(oversleep + s_min_spin_margin);
+                spin_margin_ = std::clamp<clock::duration>(std::max(wanted, spin_margin_ * 15 / 16), s_min_spin_margin, s_max_spin_margin);
+            }
+
+            while (clock::now() < deadline_)
+                std::this_thread::yield();
+
+            now = clock::now();
+        }
+        else
+        {
+            stats_.missed_deadlines++;
+        }
+
+        if (last_frame_ != clock::time_point {})
+        {
+            const float frame_ms = std::chrono::duration<float, std::milli>(now - last_frame_).count();
+            const float jitter_ms = std::abs(frame_ms - 1000.0f / target_fps_);
+
+            stats_.frames++;
+            stats_.last_frame_ms = frame_ms;
+            stats_.max_jitter_ms = std::max(stats_.max_jitter_ms, jitter_ms);
+            jitter_sum_ms_ += jitter_ms;
+            stats_.average_jitter_ms = (float)(jitter_sum_ms_ / (double)stats_.frames);
+        }
+        last_frame_ = now;
+
+        // after a missed deadline restart the schedule from now instead of rushing frames out to catch up
+        deadline_ += period_;
+        if (deadline_ < now)
+            deadline_ = now + period_;
+    }
+}
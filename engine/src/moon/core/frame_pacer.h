@@ -0,0 +1,46 @@
+#pragma once
+
+#include "core.h"
+
+#include <chrono>
+
+namespace moon
+{
+    struct frame_pacer_stats
+    {
+        uint64_t frames = 0;
+        uint64_t missed_deadlines = 0;
+        float last_frame_ms = 0.0f;
+        float average_jitter_ms = 0.0f; // mean |frame time - target|
+        float max_jitter_ms = 0.0f;
+    };
+
+    /// Caps the frame rate independently of vsync. Waits sleep for the bulk of the time and spin for the last
+    /// stretch, whose length adapts to how late the os wakes us, so frames land on their deadlines
+    /// without burning a core
+    class MOON_API frame_pacer
+    {
+    public:
+        /// 0 disables the cap
+        void set_target_fps(float fps);
+        [[nodiscard]] float get_target_fps() const { return target_fps_; }
+
+        /// Blocks until the current frame's deadline, call right before presenting
+        void wait();
+
+        [[nodiscard]] const frame_pacer_stats& get_stats() const { return stats_; }
+        void reset_stats() { stats_ = {}; jitter_sum_ms_ = 0.0; }
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        float target_fps_ = 0.0f;
+        clock::duration period_ {};
+        clock::time_point deadline_ {};
+        clock::time_point last_frame_ {};
+        clock::duration spin_margin_ = std::chrono::microseconds(1500);
+
+        frame_pacer_stats stats_;
+        double jitter_sum_ms_ = 0.0;
+    };
+}
@@ -0,0 +1,191 @@
+#include "moonpch.h"
+
+#include "moon/core/input.h"
+
+#include "moon/events/event.h"
+#include "moon/events/key_event.h"
+#include "moon/events/mouse_event.h"
+
+#include <atomic>
+
+namespace moon
+{
+    // written by events during the frame, published by new_frame()
+    static input_snapshot s_pending;
+    static bool s_has_mouse_position = false;
+    static float s_published_mouse_x = 0.0f, s_published_mouse_y = 0.0f;
+
+    static input_snapshot s_snapshots[3];
+    // number of snapshots published so far, the current one is s_snapshots[s_published % 3]
+    static std::atomic<uint64_t> s_published { 0 };
+
+    /// Runs read on the current snapshot and retries if new_frame could have started rewriting that slot
+    /// meanwhile. A slot is reused by the publish after next, so the read is intact while the count moved
+    /// on by at most one
+    template<typename F>
+    static auto read_current(F&& read)
+    {
+        for (;;)
+        {
+            const uint64_t published = s_published.load(std::memory_order_acquire);
+            auto result = read(s_snapshots[published % 3]);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s_published.load(std::memory_order_relaxed) - published < 2)
+                return result;
+        }
+    }
+
+    static bool valid_key(int keycode)
+    {
+        return keycode >= 0 && (size_t)keycode < input_snapshot::max_keys;
+    }
+
+    static bool valid_button(int button)
+    {
+        return button >= 0 && (size_t)button < input_snapshot::max_mouse_buttons;
+    }
+
+    bool input::is_key_pressed(KeyCode key)
+    {
+        return valid_key((int)key) && read_current([=](const input_snapshot& s) { return s.keys_down.test((size_t)key); });
+    }
+
+    bool input::was_key_pressed_this_frame(KeyCode key)
+    {
+        return valid_key((int)key) && read_current([=](const input_snapshot& s) { return s.keys_pressed.test((size_t)key); });
+    }
+
+    bool input::was_key_released_this_frame(KeyCode key)
+    {
+        return valid_key((int)key) && read_current([=](const input_snapshot& s) { return s.keys_released.test((size_t)key); });
+    }
+
+    bool input::is_mouse_button_pressed(MouseCode button)
+    {
+        return valid_button((int)button) && read_current([=](const input_snapshot& s) { return s.buttons_down.test((size_t)button); });
+    }
+
+    bool input::was_mouse_button_pressed_this_frame(MouseCode button)
+    {
+        return valid_button((int)button) && read_current([=](const input_snapshot& s) { return s.buttons_pressed.test((size_t)button); });
+    }
+
+    bool input::was_mouse_button_released_this_frame(MouseCode button)
+    {
+        return valid_button((int)button) && read_current([=](const input_snapshot& s) { return s.buttons_released.test((size_t)button); });
+    }
+
+    std::pair<float, float> input::get_mouse_position()
+    {
+        return read_current([](const input_snapshot& s) { return std::pair { s.mouse_x, s.mouse_y }; });
+    }
+
+    float input::get_mouse_x()
+    {
+        return read_current([](const input_snapshot& s) { return s.mouse_x; });
+    }
+
+    float input::get_mouse_y()
+    {
+        return read_current([](const input_snapshot& s) { return s.mouse_y; });
+    }
+
+    std::pair<float, float> input::get_mouse_delta()
+    {
+        return read_current([](const input_snapshot& s) { return std::pair { s.mouse_delta_x, s.mouse_delta_y }; });
+    }
+
+    std::pair<float, float> input::get_scroll_delta()
+    {
+        return read_current([](const input_snapshot& s) { return std::pair { s.scroll_x, s.scroll_y }; });
+    }
+
+    input_snapshot input::get_snapshot()
+    {
+        return read_current([](const input_snapshot& s) { return s; });
+    }
+
+    void input::on_event(const event& e)
+    {
+        switch (e.get_type())
+        {
+        case event_type::KEY_PRESSED:
+        {
+            const auto& ke = static_cast<const key_pressed_event&>(e);
+            if (!valid_key(ke.get_keycode()))
+                break;
+            // repeats don't count as a new press
+            if (ke.get_repeat_count() == 0)
+                s_pending.keys_pressed.set((size_t)ke.get_keycode());
+            s_pending.keys_down.set((size_t)ke.get_keycode());
+        } break;
+        case event_type::KEY_RELEASED:
+        {
+            const auto& ke = static_cast<const key_released_event&>(e);
+            if (!valid_key(ke.get_keycode()))
+                break;
+            s_pending.keys_released.set((size_t)ke.get_keycode());
+            s_pending.keys_down.reset((size_t)ke.get_keycode());
+        } break;
+        case event_type::MOUSE_BUTTON_PRESSED:
+        {
+            const auto& me = static_cast<const mouse_pressed_event&>(e);
+            if (!valid_button(me.get_mouse_button()))
+                break;
+            s_pending.buttons_pressed.set((size_t)me.get_mouse_button());
+            s_pending.buttons_down.set((size_t)me.get_mouse_button());
+        } break;
+        case event_type::MOUSE_BUTTON_RELEASED:
+        {
+            const auto& me = static_cast<const mouse_released_event&>(e);
+            if (!valid_button(me.get_mouse_button()))
+                break;
+            s_pending.buttons_released.set((size_t)me.get_mouse_button());
+            s_pending.buttons_down.reset((size_t)me.get_mouse_button());
+        } break;
+        case event_type::MOUSE_MOVED_EVENT:
+        {
+            const auto& me = static_cast<const mouse_moved_event&>(e);
+            s_pending.mouse_x = me.get_x();
+            s_pending.mouse_y = me.get_y();
+            if (!s_has_mouse_position)
+            {
+                // no delta for the very first position we learn about
+                s_published_mouse_x = me.get_x();
+                s_published_mouse_y = me.get_y();
+                s_has_mouse_position = true;
+            }
+        } break;
+        case event_type::MOUSE_SCROLLED:
+        {
+            const auto& me = static_cast<const mouse_scrolled_event&>(e);
+            s_pending.scroll_x += me.get_x_offset();
+            s_pending.scroll_y += me.get_y_offset();
+        } break;
+        default:
+            break;
+        }
+    }
+
+    void input::new_frame()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        s_pending.mouse_delta_x = s_pending.mouse_x - s_published_mouse_x;
+        s_pending.mouse_delta_y = s_pending.mouse_y - s_published_mouse_y;
+        s_published_mouse_x = s_pending.mouse_x;
+        s_published_mouse_y = s_pending.mouse_y;
+
+        // readers that started on the slot being overwritten notice the count moved on twice and retry
+        const uint64_t next = s_published.load(std::memory_order_relaxed) + 1;
+        s_snapshots[next % 3] = s_pending;
+        s_published.store(next, std::memory_order_release);
+
+        s_pending.keys_pressed.reset();
+        s_pending.keys_released.reset();
+        s_pending.buttons_pressed.reset();
+        s_pending.buttons_released.reset();
+        s_pending.scroll_x = 0.0f;
+        s_pending.scroll_y = 0.0f;
+    }
+}
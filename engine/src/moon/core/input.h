@@ -1,17 +1,60 @@
 #pragma once
 
 #include "core.h"
+#include "moon/core/key_codes.h"
+#include "moon/core/mouse_codes.h"
+
+#include <bitset>
+#include <utility>
 
 namespace moon
 {
+    class event;
+
+    /// State of the input devices for one frame, built from the event stream
+    struct MOON_API input_snapshot
+    {
+        static constexpr size_t max_keys = 512;
+        static constexpr size_t max_mouse_buttons = 8;
+
+        std::bitset<max_keys> keys_down;
+        std::bitset<max_keys> keys_pressed;  // went down during the frame
+        std::bitset<max_keys> keys_released; // went up during the frame
+
+        std::bitset<max_mouse_buttons> buttons_down;
+        std::bitset<max_mouse_buttons> buttons_pressed;
+        std::bitset<max_mouse_buttons> buttons_released;
+
+        float mouse_x = 0.0f, mouse_y = 0.0f;
+        float mouse_delta_x = 0.0f, mouse_delta_y = 0.0f;
+        float scroll_x = 0.0f, scroll_y = 0.0f;
+    };
+
+    /// Queries read a snapshot published once per frame, so they are bit tests rather than platform calls.
+    /// Snapshots are triple buffered behind a publish counter, and a read that overlaps a publish into its
+    /// slot is retried, so every query is safe from worker threads.
     class MOON_API input
     {
     public:
         static bool is_key_pressed(KeyCode key);
+        static bool was_key_pressed_this_frame(KeyCode key);
+        static bool was_key_released_this_frame(KeyCode key);
 
         static bool is_mouse_button_pressed(MouseCode button);
+        static bool was_mouse_button_pressed_this_frame(MouseCode button);
+        static bool was_mouse_button_released_this_frame(MouseCode button);
+
         static std::pair<float, float> get_mouse_position();
         static float get_mouse_x();
         static float get_mouse_y();
+        static std::pair<float, float> get_mouse_delta();
+        static std::pair<float, float> get_scroll_delta();
+
+        /// A copy, it stays valid however long the caller holds it
+        static input_snapshot get_snapshot();
+
+        // driven by application on the main thread
+        static void on_event(const event& e);
+        static void new_frame();
     };
 }
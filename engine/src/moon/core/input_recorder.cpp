@@ -0,0 +1,140 @@
+#include "moonpch.h"
+#include "input_recorder.h"
+
+#include "moon/events/event.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+namespace moon
+{
+    static constexpr uint32_t s_input_recording_magic = 0x504E494D; // "MINP"
+    static constexpr uint32_t s_input_recording_version = 1;
+
+    static_assert(std::is_trivially_copyable_v<queued_event>);
+
+    bool input_recorder::open(std::string_view filepath)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        close();
+
+        stream_.open(std::string(filepath), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!stream_)
+        {
+            MOON_CORE_ERROR("Could not open input recording '{0}' for writing", filepath);
+            return false;
+        }
+
+        // frame_count is patched in by close()
+        const input_recording_header header { s_input_recording_magic, s_input_recording_version, 0, (uint32_t)sizeof(queued_event) };
+        stream_.write((const char*)&header, sizeof(header));
+
+        pending_.clear();
+        frame_count_ = 0;
+
+        MOON_CORE_INFO("Recording input to '{0}'", filepath);
+        return true;
+    }
+
+    void input_recorder::close()
+    {
+        if (!stream_.is_open())
+            return;
+
+        stream_.seekp(offsetof(input_recording_header, frame_count));
+        stream_.write((const char*)&frame_count_, sizeof(frame_count_));
+        stream_.close();
+
+        MOON_CORE_INFO("Input recording finished, {0} frames", frame_count_);
+    }
+
+    void input_recorder::record_event(const event& e)
+    {
+        if (!stream_.is_open() || !e.is_in_category(EVENT_CATEGORY_INPUT))
+            return;
+
+        queued_event qe;
+        if (queued_event::from_event(e, qe))
+            pending_.push_back(qe);
+    }
+
+    void input_recorder::end_frame(float timestep)
+    {
+        if (!stream_.is_open())
+            return;
+
+        const input_frame_record frame { timestep, (uint32_t)pending_.size() };
+        stream_.write((const char*)&frame, sizeof(frame));
+        stream_.write((const char*)pending_.data(), (std::streamsize)(pending_.size() * sizeof(queued_event)));
+
+        pending_.clear();
+        frame_count_++;
+    }
+
+    bool input_replayer::open(std::string_view filepath)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        if (!file_.open(filepath))
+        {
+            MOON_CORE_ERROR("Could not open input recording '{0}'", filepath);
+            return false;
+        }
+
+        input_recording_header header;
+        if (file_.size() < sizeof(header))
+        {
+            MOON_CORE_ERROR("'{0}' is not an input recording", filepath);
+            file_.close();
+            return false;
+        }
+
+        std::memcpy(&header, file_.data(), sizeof(header));
+        if (header.magic != s_input_recording_magic || header.version != s_input_recording_version
+            || header.event_size != sizeof(queued_event))
+        {
+            MOON_CORE_ERROR("'{0}' is not a compatible input recording", filepath);
+            file_.close();
+            return false;
+        }
+
+        offset_ = sizeof(header);
+        frames_played_ = 0;
+        frame_times_.clear();
+        frame_times_.reserve(header.frame_count);
+
+        MOON_CORE_INFO("Replaying {0} frames of input from '{1}'", header.frame_count, filepath);
+        return true;
+    }
+
+    void input_replayer::report_frame_times(std::string_view csv_path) const
+    {
+        if (frame_times_.empty())
+            return;
+
+        std::vector<float> sorted = frame_times_;
+        std::ranges::sort(sorted);
+
+        float total = 0.0f;
+        for (float ms : sorted)
+            total += ms;
+
+        const auto percentile = [&](float p) { return sorted[(size_t)(p * (float)(sorted.size() - 1))]; };
+
+        MOON_CORE_INFO("Replay frame times over {0} frames: min {1:.3f}ms, avg {2:.3f}ms, p50 {3:.3f}ms, p95 {4:.3f}ms, p99 {5:.3f}ms, max {6:.3f}ms",
+            sorted.size(), sorted.front(), total / (float)sorted.size(), percentile(0.5f), percentile(0.95f), percentile(0.99f), sorted.back());
+
+        std::ofstream out { std::string(csv_path), std::ios::out | std::ios::trunc };
+        if (!out)
+        {
+            MOON_CORE_ERROR("Could not write frame times to '{0}'", csv_path);
+            return;
+        }
+
+        out << "frame,ms\n";
+        for (size_t i = 0; i < frame_times_.size(); i++)
+            out << i << ',' << frame_times_[i] << '\n';
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "core.h"
+#include "moon/core/mapped_file.h"
+#include "moon/events/event_queue.h"
+
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <vector>
+
+namespace moon
+{
+    class event;
+
+    // .minp layout: input_recording_header, then one input_frame_record per frame,
+    // each followed by event_count raw queued_event records
+    struct input_recording_header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t frame_count;
+        uint32_t event_size;
+    };
+
+    struct input_frame_record
+    {
+        float timestep;
+        uint32_t event_count;
+    };
+
+    /// Captures the input events and timestep of every frame to a compact binary file, so a session can be
+    /// fed back through input_replayer
+    class MOON_API input_recorder
+    {
+    public:
+        input_recorder() = default;
+        ~input_recorder() { close(); }
+
+        bool open(std::string_view filepath);
+        void close();
+        [[nodiscard]] bool is_open() const { return stream_.is_open(); }
+
+        /// Holds on to an input event until the frame that consumes it ends; window events are ignored
+        void record_event(const event& e);
+        /// Writes the events recorded since the last call, tagged with the timestep of the frame they feed
+        void end_frame(float timestep);
+
+    private:
+        std::ofstream stream_;
+        std::vector<queued_event> pending_;
+        uint32_t frame_count_ = 0;
+    };
+
+    /// Plays back a recording one frame at a time and keeps the measured frame times for comparison between builds
+    class MOON_API input_replayer
+    {
+    public:
+        bool open(std::string_view filepath);
+        [[nodiscard]] bool is_open() const { return file_.is_open(); }
+
+        /// Hands the next frame's events to fn, false once the recording is exhausted
+        template<typename Fn>
+        bool next_frame(Fn&& fn)
+        {
+            input_frame_record frame;
+            if (file_.size() - offset_ < sizeof(frame))
+                return false;
+            std::memcpy(&frame, file_.data() + offset_, sizeof(frame));
+            offset_ += sizeof(frame);
+
+            if ((file_.size() - offset_) / sizeof(queued_event) < frame.event_count)
+                return false;
+
+            for (uint32_t i = 0; i < frame.event_count; i++)
+            {
+                queued_event qe;
+                std::memcpy(&qe, file_.data() + offset_, sizeof(qe));
+                offset_ += sizeof(qe);
+                dispatch_queued_event(qe, fn);
+            }
+
+            recorded_timestep_ = frame.timestep;
+            frames_played_++;
+            return true;
+        }
+
+        [[nodiscard]] float get_recorded_timestep() const { return recorded_timestep_; }
+        [[nodiscard]] uint32_t get_frames_played() const { return frames_played_; }
+
+        void add_frame_time(float milliseconds) { frame_times_.push_back(milliseconds); }
+        /// Logs min/avg/percentiles/max and writes every frame time to a csv file
+        void report_frame_times(std::string_view csv_path) const;
+
+    private:
+        mapped_file file_;
+        size_t offset_ = 0;
+        float recorded_timestep_ = 0.0f;
+        uint32_t frames_played_ = 0;
+        std::vector<float> frame_times_;
+    };
+}
@@ -14,6 +14,8 @@ namespace moon
         virtual void on_attach() {};
         virtual void on_detach() {};
         virtual void on_update([[maybe_unused]] timestep ts) {};
+        /// Runs zero or more times per frame at the application's fixed rate, before on_update
+        virtual void on_fixed_update([[maybe_unused]] timestep fixed_ts) {};
         virtual void on_imgui_render() {};
         virtual void on_event(event&) {};
 
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "moon/core/core.h"
+
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace moon
+{
+    /// Read-only memory mapping of a whole file. The mapping stays valid until close() or destruction,
+    /// so pointers into data() can be handed out for zero-copy loading.
+    /// open/close/prefetch are implemented with mmap on linux and apple, with file mappings on windows.
+    class MOON_API mapped_file
+    {
+    public:
+        mapped_file() = default;
+        explicit mapped_file(std::string_view path) { open(path); }
+        ~mapped_file() { close(); }
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        mapped_file(mapped_file&& other) noexcept
+            :
+            data_(std::exchange(other.data_, nullptr)),
+            size_(std::exchange(other.size_, 0))
+        {}
+
+        mapped_file& operator=(mapped_file&& other) noexcept
+        {
+            if (this != &other)
+            {
+                close();
+                data_ = std::exchange(other.data_, nullptr);
+                size_ = std::exchange(other.size_, 0);
+            }
+            return *this;
+        }
+
+        bool open(std::string_view path);
+        void close();
+
+        /// Asks the OS to start paging the whole file in, so later reads don't fault page by page
+        void prefetch() const;
+
+        [[nodiscard]] bool is_open() const { return data_ != nullptr; }
+        [[nodiscard]] const uint8_t* data() const { return data_; }
+        [[nodiscard]] size_t size() const { return size_; }
+
+    private:
+        const uint8_t* data_ = nullptr;
+        size_t size_ = 0;
+    };
+}
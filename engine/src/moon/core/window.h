@@ -8,15 +8,26 @@
 
 namespace moon
 {
+    enum class vsync_mode
+    {
+        off,
+        on,
+        // syncs when the frame is on time and tears instead of waiting a whole interval when it's late.
+        // falls back to on where the driver lacks swap_control_tear
+        adaptive
+    };
+
     struct window_props
     {
-        explicit window_props(std::string_view title = "Moon Engine", uint32_t width = 1280, uint32_t height = 720)
-            : title(title), width(width), height(height)
+        explicit window_props(std::string_view title = "Moon Engine", uint32_t width = 1280, uint32_t height = 720,
+            vsync_mode vsync = vsync_mode::on)
+            : title(title), width(width), height(height), vsync(vsync)
         {}
 
         std::string title;
         uint32_t width;
         uint32_t height;
+        vsync_mode vsync;
     };
 
     // abstract class of a desktop window
@@ -32,7 +43,10 @@ namespace moon
             context_ = nullptr;
         }
 
+        /// Presents the frame and dispatches pending events
         virtual void on_update() = 0;
+        /// Sleeps until an event arrives or timeout_seconds pass, then dispatches pending events
+        virtual void wait_events(float timeout_seconds) = 0;
 
         [[nodiscard]] virtual uint32_t get_width() const = 0;
         [[nodiscard]] virtual uint32_t get_height() const = 0;
@@ -41,6 +55,8 @@ namespace moon
         virtual void set_event_callback(const event_callback_fn& fn) = 0;
         virtual void set_vsync(bool enabled) = 0;
         [[nodiscard]] virtual bool is_vsync() const = 0;
+        virtual void set_vsync_mode(vsync_mode mode) = 0;
+        [[nodiscard]] virtual vsync_mode get_vsync_mode() const = 0;
 
         [[nodiscard]] virtual void* get_native_window() const = 0;
 
@@ -9,6 +9,7 @@ namespace moon
     public:
         window_resize_event(uint32_t width, uint32_t height)
             :
+            event(get_static_type()),
             width_(width),
             height_(height)
         {}
@@ -33,7 +34,10 @@ namespace moon
     class MOON_API window_close_event : public event
     {
     public:
-        window_close_event() = default;
+        window_close_event()
+            :
+            event(get_static_type())
+        {}
 
         EVENT_CLASS_TYPE(WINDOW_CLOSE)
         EVENT_CLASS_CATEGORY(EVENT_CATEGORY_APPLICATION)
@@ -42,7 +46,10 @@ namespace moon
     class MOON_API window_focus_event : public event
     {
     public:
-        window_focus_event() = default;
+        window_focus_event()
+            :
+            event(get_static_type())
+        {}
 
         EVENT_CLASS_TYPE(WINDOW_FOCUS)
         EVENT_CLASS_CATEGORY(EVENT_CATEGORY_APPLICATION)
@@ -51,7 +58,10 @@ namespace moon
     class MOON_API window_lost_focus_event : public event
     {
     public:
-        window_lost_focus_event() = default;
+        window_lost_focus_event()
+            :
+            event(get_static_type())
+        {}
 
         EVENT_CLASS_TYPE(WINDOW_LOST_FOCUS)
         EVENT_CLASS_CATEGORY(EVENT_CATEGORY_APPLICATION)
@@ -60,7 +70,10 @@ namespace moon
     class MOON_API app_tick_event : public event
     {
     public:
-        app_tick_event() = default;
+        app_tick_event()
+            :
+            event(get_static_type())
+        {}
 
         EVENT_CLASS_TYPE(APP_TICK)
         EVENT_CLASS_CATEGORY(EVENT_CATEGORY_APPLICATION)
@@ -69,7 +82,10 @@ namespace moon
     class MOON_API app_update_event : public event
     {
     public:
-        app_update_event() = default;
+        app_update_event()
+            :
+            event(get_static_type())
+        {}
 
         EVENT_CLASS_TYPE(APP_UPDATE)
         EVENT_CLASS_CATEGORY(EVENT_CATEGORY_APPLICATION)
@@ -78,7 +94,10 @@ namespace moon
     class MOON_API app_render_event : public event
     {
     public:
-        app_render_event() = default;
+        app_render_event()
+            :
+            event(get_static_type())
+        {}
 
         EVENT_CLASS_TYPE(APP_RENDER)
         EVENT_CLASS_CATEGORY(EVENT_CATEGORY_APPLICATION)
@@ -3,7 +3,7 @@
 #include "moon/core/core.h"
 
 #include <string>
-#include <functional>
+#include <ostream>
 
 namespace moon
 {
@@ -36,8 +36,9 @@ namespace moon
         EVENT_CATEGORY_MOUSE_BUTTON = BIT(4)
     };
 
-#define EVENT_CLASS_TYPE(type) static event_type get_static_type() { return event_type::type; }\
-                                virtual event_type get_type() const override { return get_static_type(); }\
+// the type id lives in the event base class, so type checks never go through the vtable.
+// constructors pass get_static_type() down to event
+#define EVENT_CLASS_TYPE(type) static constexpr event_type get_static_type() { return event_type::type; }\
                                 virtual const char* get_name() const override { return #type; }
 
 #define EVENT_CLASS_CATEGORY(category) virtual int get_category() const override { return category; }
@@ -53,7 +54,7 @@ namespace moon
 
         bool handled = false;
 
-        [[nodiscard]] virtual event_type get_type() const = 0;
+        [[nodiscard]] event_type get_type() const { return type_; }
         [[nodiscard]] virtual const char* get_name() const = 0;
         [[nodiscard]] virtual int get_category() const = 0;
         [[nodiscard]] virtual std::string to_string() const { return get_name(); }
@@ -62,26 +63,33 @@ namespace moon
         {
             return get_category() & category;
         }
+    protected:
+        explicit event(event_type type)
+            :
+            type_(type)
+        {}
+
     private:
+        event_type type_;
     };
 
     class event_dispatcher
     {
-        template<typename T>
-        using event_fn = std::function<bool(T&)>;
-
     public:
         explicit event_dispatcher(event& event)
             :
             event_(event)
         {}
 
-        template<typename T>
-        bool dispatch(event_fn<T> func)
+        /// F is any callable taking T& and returning bool. It is taken as a template parameter, so lambdas are
+        /// invoked inline rather than through std::function, and a chain of dispatch calls folds into
+        /// comparisons against a single load of the event's type id
+        template<typename T, typename F>
+        bool dispatch(F&& func)
         {
             if (event_.get_type() == T::get_static_type())
             {
-                event_.handled = func(*(T*)&event_);
+                event_.handled = func(static_cast<T&>(event_));
                 return true;
             }
             return false;
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "moon/core/core.h"
+#include "moon/core/log.h"
+#include "moon/debug/instrumentor.h"
+
+#include "event.h"
+#include "application_event.h"
+#include "key_event.h"
+#include "mouse_event.h"
+
+#include <vector>
+
+namespace moon
+{
+    /// Plain-data, type-tagged record of a platform event. Queues store these instead of event objects,
+    /// so recording an event never touches the heap.
+    struct queued_event
+    {
+        event_type type = event_type::NONE;
+        union
+        {
+            struct { uint32_t width, height; } resize;
+            struct { int32_t keycode, repeat_count; } key;
+            struct { int32_t button; } mouse_button;
+            struct { float x, y; } mouse; // cursor position for moves, offsets for scrolls
+        };
+
+        static queued_event make_window_resize(uint32_t width, uint32_t height)
+        {
+            queued_event e;
+            e.type = event_type::WINDOW_RESIZE;
+            e.resize = { width, height };
+            return e;
+        }
+        static queued_event make_window_close()
+        {
+            queued_event e;
+            e.type = event_type::WINDOW_CLOSE;
+            return e;
+        }
+        static queued_event make_key(event_type type, int32_t keycode, int32_t repeat_count = 0)
+        {
+            queued_event e;
+            e.type = type;
+            e.key = { keycode, repeat_count };
+            return e;
+        }
+        static queued_event make_mouse_button(event_type type, int32_t button)
+        {
+            queued_event e;
+            e.type = type;
+            e.mouse_button = { button };
+            return e;
+        }
+        static queued_event make_mouse(event_type type, float x, float y)
+        {
+            queued_event e;
+            e.type = type;
+            e.mouse = { x, y };
+            return e;
+        }
+
+        /// Inverse of dispatch_queued_event, false for event types that can't be queued
+        static bool from_event(const event& e, queued_event& out)
+        {
+            switch (e.get_type())
+            {
+            case event_type::WINDOW_RESIZE:
+            {
+                const auto& re = static_cast<const window_resize_event&>(e);
+                out = make_window_resize(re.get_width(), re.get_height());
+            } return true;
+            case event_type::WINDOW_CLOSE:
+                out = make_window_close();
+                return true;
+            case event_type::KEY_TYPED:
+            case event_type::KEY_RELEASED:
+                out = make_key(e.get_type(), static_cast<const key_event&>(e).get_keycode());
+                return true;
+            case event_type::KEY_PRESSED:
+            {
+                const auto& ke = static_cast<const key_pressed_event&>(e);
+                out = make_key(e.get_type(), ke.get_keycode(), ke.get_repeat_count());
+            } return true;
+            case event_type::MOUSE_BUTTON_PRESSED:
+            case event_type::MOUSE_BUTTON_RELEASED:
+                out = make_mouse_button(e.get_type(), static_cast<const mouse_button_event&>(e).get_mouse_button());
+                return true;
+            case event_type::MOUSE_SCROLLED:
+            {
+                const auto& me = static_cast<const mouse_scrolled_event&>(e);
+                out = make_mouse(e.get_type(), me.get_x_offset(), me.get_y_offset());
+            } return true;
+            case event_type::MOUSE_MOVED_EVENT:
+            {
+                const auto& me = static_cast<const mouse_moved_event&>(e);
+                out = make_mouse(e.get_type(), me.get_x(), me.get_y());
+            } return true;
+            default:
+                return false;
+            }
+        }
+    };
+
+    /// Rebuilds the concrete event on the stack and hands it to fn
+    template<typename Fn>
+    void dispatch_queued_event(const queued_event& qe, Fn&& fn)
+    {
+        switch (qe.type)
+        {
+        case event_type::WINDOW_RESIZE:         { window_resize_event e(qe.resize.width, qe.resize.height); fn(e); } break;
+        case event_type::WINDOW_CLOSE:          { window_close_event e; fn(e); } break;
+        case event_type::KEY_TYPED:             { key_typed_event e(qe.key.keycode); fn(e); } break;
+        case event_type::KEY_PRESSED:           { key_pressed_event e(qe.key.keycode, qe.key.repeat_count); fn(e); } break;
+        case event_type::KEY_RELEASED:          { key_released_event e(qe.key.keycode); fn(e); } break;
+        case event_type::MOUSE_BUTTON_PRESSED:  { mouse_pressed_event e(qe.mouse_button.button); fn(e); } break;
+        case event_type::MOUSE_BUTTON_RELEASED: { mouse_released_event e(qe.mouse_button.button); fn(e); } break;
+        case event_type::MOUSE_SCROLLED:        { mouse_scrolled_event e(qe.mouse.x, qe.mouse.y); fn(e); } break;
+        case event_type::MOUSE_MOVED_EVENT:     { mouse_moved_event e(qe.mouse.x, qe.mouse.y); fn(e); } break;
+        default:
+            MOON_CORE_ASSERT(false, "Event type can't be queued!");
+        }
+    }
+
+    /// Collects platform events during polling so they can be dispatched in one go once per frame.
+    /// Storage is reserved up front and reused, and redundant events are coalesced on push:
+    /// consecutive mouse moves collapse into the latest position, and all resizes within a frame collapse
+    /// into the final size at the position of the first one.
+    class event_queue
+    {
+    public:
+        explicit event_queue(size_t capacity = 256)
+        {
+            events_.reserve(capacity);
+        }
+
+        void push(const queued_event& e)
+        {
+            switch (e.type)
+            {
+            case event_type::MOUSE_MOVED_EVENT:
+                if (!events_.empty() && events_.back().type == event_type::MOUSE_MOVED_EVENT)
+                {
+                    events_.back() = e;
+                    return;
+                }
+                break;
+            case event_type::WINDOW_RESIZE:
+                if (pending_resize_ != s_no_resize)
+                {
+                    events_[pending_resize_] = e;
+                    return;
+                }
+                pending_resize_ = events_.size();
+                break;
+            default:
+                break;
+            }
+
+            events_.push_back(e);
+        }
+
+        template<typename Fn>
+        void drain(Fn&& fn)
+        {
+            MOON_PROFILE_FUNCTION();
+
+            for (size_t i = 0; i < events_.size(); i++)
+                dispatch_queued_event(events_[i], fn);
+
+            clear();
+        }
+
+        void clear()
+        {
+            events_.clear();
+            pending_resize_ = s_no_resize;
+        }
+
+        [[nodiscard]] bool empty() const { return events_.empty(); }
+        [[nodiscard]] size_t size() const { return events_.size(); }
+
+    private:
+        static constexpr size_t s_no_resize = ~(size_t)0;
+
+        std::vector<queued_event> events_;
+        size_t pending_resize_ = s_no_resize;
+    };
+}
@@ -13,8 +13,9 @@ namespace moon
 
         EVENT_CLASS_CATEGORY(EVENT_CATEGORY_KEYBOARD | EVENT_CATEGORY_INPUT)
     protected:
-        explicit key_event(int keycode)
+        key_event(event_type type, int keycode)
             :
+            event(type),
             keycode_(keycode)
         {}
 
@@ -26,7 +27,7 @@ namespace moon
     public:
         explicit key_typed_event(int keycode)
             :
-            key_event(keycode)
+            key_event(get_static_type(), keycode)
         {}
 
         EVENT_CLASS_TYPE(KEY_TYPED)
@@ -44,7 +45,7 @@ namespace moon
     public:
         key_pressed_event(int keycode, int repeat_count)
             :
-            key_event(keycode),
+            key_event(get_static_type(), keycode),
             repeat_count_(repeat_count)
         {}
 
@@ -67,7 +68,7 @@ namespace moon
     public:
         key_released_event(int keycode)
             :
-            key_event(keycode)
+            key_event(get_static_type(), keycode)
         {}
         EVENT_CLASS_TYPE(KEY_RELEASED)
 
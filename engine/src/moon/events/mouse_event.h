@@ -9,6 +9,7 @@ namespace moon
     public:
         mouse_moved_event(float x, float y)
             :
+            event(get_static_type()),
             x_(x),
             y_(y)
         {}
@@ -35,6 +36,7 @@ namespace moon
     public:
         mouse_scrolled_event(float x_offset, float y_offset)
             :
+            event(get_static_type()),
             x_offset_(x_offset),
             y_offset_(y_offset)
         {}
@@ -63,8 +65,9 @@ namespace moon
 
         EVENT_CLASS_CATEGORY(EVENT_CATEGORY_MOUSE | EVENT_CATEGORY_INPUT)
     protected:
-        explicit mouse_button_event(int button)
+        mouse_button_event(event_type type, int button)
             :
+            event(type),
             button_(button)
         {}
 
@@ -76,7 +79,7 @@ namespace moon
     public:
         explicit mouse_pressed_event(int button)
             :
-            mouse_button_event(button)
+            mouse_button_event(get_static_type(), button)
         {}
 
         EVENT_CLASS_TYPE(MOUSE_BUTTON_PRESSED)
@@ -94,7 +97,7 @@ namespace moon
     public:
         explicit mouse_released_event(int button)
             :
-            mouse_button_event(button)
+            mouse_button_event(get_static_type(), button)
         {}
 
         EVENT_CLASS_TYPE(MOUSE_BUTTON_RELEASED)
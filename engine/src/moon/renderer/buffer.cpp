@@ -50,4 +50,19 @@ namespace moon
         MOON_CORE_ASSERT(false, "Unknown RendererAPI!");
         return nullptr;
     }
+
+    ref<uniform_buffer> uniform_buffer::create(uint32_t size, uint32_t binding)
+    {
+        switch (renderer::get_api())
+        {
+        case renderer_api::API::None:
+            MOON_CORE_ASSERT(false, "RendererAPI::None is not supported");
+            return nullptr;
+        case renderer_api::API::OpenGL:
+            return std::make_shared<opengl_uniform_buffer>(size, binding);
+        }
+
+        MOON_CORE_ASSERT(false, "Unknown RendererAPI!");
+        return nullptr;
+    }
 }
@@ -6,7 +6,9 @@ namespace moon
 {
     enum class ShaderDataType : uint8_t
     {
-        None = 0, Float, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, Bool
+        None = 0, Float, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, Bool,
+        // four bytes, read as a vec4 when normalized (packed colors)
+        UByte4
     };
 
     static uint32_t shader_data_type_size(ShaderDataType type)
@@ -24,6 +26,7 @@ namespace moon
         case ShaderDataType::Int3:     return 4 * 3;
         case ShaderDataType::Int4:     return 4 * 4;
         case ShaderDataType::Bool:     return 1;
+        case ShaderDataType::UByte4:   return 4;
         default:
             MOON_CORE_ASSERT(false, "Unknown ShaderDataType!");
             return 0;
@@ -59,6 +62,7 @@ namespace moon
                 case ShaderDataType::Int3:     return 3;
                 case ShaderDataType::Int4:     return 4;
                 case ShaderDataType::Bool:     return 1;
+                case ShaderDataType::UByte4:   return 4;
                 default:
                     MOON_CORE_ASSERT(false, "Unknown ShaderDataType!"); return 0;
             }
@@ -107,6 +111,8 @@ namespace moon
         virtual void bind() const = 0;
         virtual void unbind() const = 0;
 
+        /// Replaces the contents from the start. Buffers created with a size are orphaned first, so refilling
+        /// one several times a frame never waits for draws still reading the previous contents
         virtual void set_data(const void* data, uint32_t size) = 0;
 
         virtual const buffer_layout& get_layout() const = 0;
@@ -129,4 +135,16 @@ namespace moon
 
         static ref<index_buffer> create(const uint32_t* indices, uint32_t count);
     };
+
+    /// Block of uniforms shared by every shader that declares it at the same binding point,
+    /// so data uploaded once is seen by all of them without per-shader uniform calls
+    class MOON_API uniform_buffer
+    {
+    public:
+        virtual ~uniform_buffer() = default;
+
+        virtual void set_data(const void* data, uint32_t size, uint32_t offset = 0) = 0;
+
+        static ref<uniform_buffer> create(uint32_t size, uint32_t binding);
+    };
 }
@@ -0,0 +1,246 @@
+#include "moonpch.h"
+#include "font.h"
+
+#include "moon/asset/asset_archive.h"
+
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <stb_truetype.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+namespace moon
+{
+    /// Decodes one utf-8 sequence at i and advances past it, malformed bytes come back as U+FFFD
+    static uint32_t next_codepoint(std::string_view text, size_t& i)
+    {
+        const uint8_t lead = (uint8_t)text[i++];
+        if (lead < 0x80)
+            return lead;
+
+        uint32_t length;
+        uint32_t codepoint;
+        if ((lead & 0xe0) == 0xc0)      { length = 1; codepoint = lead & 0x1f; }
+        else if ((lead & 0xf0) == 0xe0) { length = 2; codepoint = lead & 0x0f; }
+        else if ((lead & 0xf8) == 0xf0) { length = 3; codepoint = lead & 0x07; }
+        else                            return 0xfffd;
+
+        for (uint32_t n = 0; n < length; n++)
+        {
+            if (i >= text.size() || ((uint8_t)text[i] & 0xc0) != 0x80)
+                return 0xfffd;
+            codepoint = (codepoint << 6) | ((uint8_t)text[i++] & 0x3f);
+        }
+        return codepoint;
+    }
+
+    font::font(std::string_view path, const font_spec& spec)
+        :
+        m_path_(path),
+        m_spec_(spec),
+        m_info_(create_scope<stbtt_fontinfo>())
+    {
+        MOON_PROFILE_FUNCTION();
+
+        if (!read_file())
+        {
+            MOON_CORE_ERROR("Could not open font '{0}'", m_path_);
+            return;
+        }
+
+        if (!stbtt_InitFont(m_info_.get(), m_file_data_.data(), stbtt_GetFontOffsetForIndex(m_file_data_.data(), 0)))
+        {
+            MOON_CORE_ERROR("'{0}' isn't a truetype font", m_path_);
+            return;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        bake();
+        const float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        MOON_CORE_INFO("Baked {0} glyphs of '{1}' in {2:.2f} ms", std::ranges::count(m_has_glyph_, true), m_path_, ms);
+    }
+
+    font::~font() = default;
+
+    bool font::read_file()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        // copied out of the archive, stb_truetype keeps reading the data after unmount_all could have run
+        packed_asset asset;
+        if (asset_archive::find(m_path_, asset))
+        {
+            m_file_data_.assign(asset.data, asset.data + asset.size);
+            return true;
+        }
+
+        // Fallback to filesystem loading
+        std::ifstream in(std::filesystem::absolute(m_path_), std::ios::in | std::ios::binary);
+        if (!in)
+            return false;
+
+        in.seekg(0, std::ios::end);
+        const std::streampos size = in.tellg();
+        if (size <= 0)
+            return false;
+
+        m_file_data_.resize((size_t)size);
+        in.seekg(0, std::ios::beg);
+        in.read((char*)m_file_data_.data(), (std::streamsize)m_file_data_.size());
+        return (bool)in;
+    }
+
+    void font::bake()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        m_scale_ = stbtt_ScaleForPixelHeight(m_info_.get(), m_spec_.pixel_height);
+
+        int ascent, descent, line_gap;
+        stbtt_GetFontVMetrics(m_info_.get(), &ascent, &descent, &line_gap);
+        m_line_height_ = (float)(ascent - descent + line_gap) * m_scale_ / m_spec_.pixel_height;
+
+        const uint32_t size = m_spec_.atlas_size;
+        std::vector<uint8_t> pixels((size_t)size * size, 0);
+
+        m_glyphs_.assign(m_spec_.codepoint_count, glyph {});
+        m_has_glyph_.assign(m_spec_.codepoint_count, false);
+
+        // shelves from the bottom up, so rows can be copied flipped and v grows upwards like everywhere else
+        constexpr uint32_t gap = 1;
+        // the edge sits at 128, and the value falls to 0 sdf_padding pixels outside of it
+        const float pixel_dist_scale = 128.0f / (float)std::max(1u, m_spec_.sdf_padding);
+        uint32_t x = gap, y = gap, shelf_height = 0;
+        for (uint32_t i = 0; i < m_spec_.codepoint_count; i++)
+        {
+            const int codepoint = (int)(m_spec_.first_codepoint + i);
+            if (!stbtt_FindGlyphIndex(m_info_.get(), codepoint))
+                continue;
+
+            int advance, left_side_bearing;
+            stbtt_GetCodepointHMetrics(m_info_.get(), codepoint, &advance, &left_side_bearing);
+
+            glyph& g = m_glyphs_[i];
+            g.advance = (float)advance * m_scale_ / m_spec_.pixel_height;
+            m_has_glyph_[i] = true;
+
+            int width = 0, height = 0, x_offset = 0, y_offset = 0;
+            uint8_t* sdf = stbtt_GetCodepointSDF(m_info_.get(), m_scale_, codepoint, (int)m_spec_.sdf_padding, 128,
+                pixel_dist_scale, &width, &height, &x_offset, &y_offset);
+            // whitespace has an advance but nothing to draw
+            if (!sdf)
+                continue;
+
+            if (x + (uint32_t)width + gap > size)
+            {
+                x = gap;
+                y += shelf_height + gap;
+                shelf_height = 0;
+            }
+            if (y + (uint32_t)height + gap > size)
+            {
+                MOON_CORE_WARN("'{0}' doesn't fit into a {1}x{1} atlas at {2} px, glyphs from U+{3:04X} on are missing",
+                    m_path_, size, m_spec_.pixel_height, (uint32_t)codepoint);
+                stbtt_FreeSDF(sdf, nullptr);
+                m_has_glyph_[i] = false;
+                break;
+            }
+
+            for (int row = 0; row < height; row++)
+                std::memcpy(&pixels[(size_t)(y + (uint32_t)(height - 1 - row)) * size + x], sdf + (size_t)row * width, (size_t)width);
+            stbtt_FreeSDF(sdf, nullptr);
+
+            // stb reports the top-left corner in y-down pixels
+            const float inv_height = 1.0f / m_spec_.pixel_height;
+            g.quad_min = { (float)x_offset * inv_height, -(float)(y_offset + height) * inv_height };
+            g.quad_max = { (float)(x_offset + width) * inv_height, -(float)y_offset * inv_height };
+            g.uv_min = { (float)x / (float)size, (float)y / (float)size };
+            g.uv_max = { (float)(x + (uint32_t)width) / (float)size, (float)(y + (uint32_t)height) / (float)size };
+
+            x += (uint32_t)width + gap;
+            shelf_height = std::max(shelf_height, (uint32_t)height);
+        }
+
+        texture_spec spec;
+        spec.format = texture_format::R8;
+        spec.min_filter = texture_filter::linear;
+        spec.mag_filter = texture_filter::linear;
+        spec.wrap = texture_wrap::clamp_to_edge;
+        m_atlas_ = texture2d::create(size, size, spec);
+        m_atlas_->set_region_data(pixels.data(), 0, 0, size, size);
+    }
+
+    const glyph* font::get_glyph(uint32_t codepoint) const
+    {
+        const uint32_t index = codepoint - m_spec_.first_codepoint;
+        if (codepoint < m_spec_.first_codepoint || index >= m_glyphs_.size() || !m_has_glyph_[index])
+            return nullptr;
+        return &m_glyphs_[index];
+    }
+
+    ref<const text_layout> font::layout(std::string_view text)
+    {
+        if (auto it = m_layout_cache_.find(text); it != m_layout_cache_.end())
+            return it->second;
+
+        MOON_PROFILE_FUNCTION();
+
+        // dynamic strings would grow it forever, callers keep their refs alive across the reset
+        if (m_layout_cache_.size() >= max_cached_layouts)
+            m_layout_cache_.clear();
+
+        ref<const text_layout> result = create_ref<const text_layout>(layout_uncached(text));
+        m_layout_cache_.emplace(std::string(text), result);
+        return result;
+    }
+
+    text_layout font::layout_uncached(std::string_view text) const
+    {
+        MOON_PROFILE_FUNCTION();
+
+        text_layout result;
+        if (!is_loaded())
+            return result;
+
+        result.quads.reserve(text.size());
+
+        const glyph* fallback = get_glyph('?');
+        const float kerning_scale = m_scale_ / m_spec_.pixel_height;
+
+        glm::vec2 pen { 0.0f };
+        uint32_t previous = 0;
+        uint32_t line_count = 1;
+        for (size_t i = 0; i < text.size();)
+        {
+            const uint32_t codepoint = next_codepoint(text, i);
+            if (codepoint == '\n')
+            {
+                pen.x = 0.0f;
+                pen.y -= m_line_height_;
+                previous = 0;
+                line_count++;
+                continue;
+            }
+
+            const glyph* g = get_glyph(codepoint);
+            if (!g)
+                g = fallback;
+            if (!g)
+                continue;
+
+            if (previous)
+                pen.x += (float)stbtt_GetCodepointKernAdvance(m_info_.get(), (int)previous, (int)codepoint) * kerning_scale;
+
+            if (g->quad_max.x > g->quad_min.x)
+                result.quads.push_back({ pen + g->quad_min, pen + g->quad_max, g->uv_min, g->uv_max });
+
+            pen.x += g->advance;
+            result.size.x = std::max(result.size.x, pen.x);
+            previous = codepoint;
+        }
+
+        result.size.y = (float)line_count * m_line_height_;
+        return result;
+    }
+}
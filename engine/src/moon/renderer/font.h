@@ -0,0 +1,103 @@
+#pragma once
+
+#include "moon/core/core.h"
+#include "moon/renderer/texture.h"
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct stbtt_fontinfo;
+
+namespace moon
+{
+    struct font_spec
+    {
+        /// Height in pixels the glyphs are rasterized at, layouts are in units of this height
+        float pixel_height = 48.0f;
+        uint32_t atlas_size = 1024;
+        /// Distance field spread in pixels around each glyph, also the gap between glyphs
+        uint32_t sdf_padding = 6;
+        /// Baked codepoint range, printable ascii by default
+        uint32_t first_codepoint = 32;
+        uint32_t codepoint_count = 95;
+    };
+
+    /// Metrics are in units of the font's pixel height, y up, relative to the pen on the baseline
+    struct glyph
+    {
+        glm::vec2 uv_min, uv_max;
+        glm::vec2 quad_min, quad_max;
+        float advance;
+    };
+
+    /// Glyph quads of a string relative to its origin, the baseline of the first line
+    struct text_layout
+    {
+        struct quad
+        {
+            glm::vec2 min, max;
+            glm::vec2 uv_min, uv_max;
+        };
+
+        std::vector<quad> quads;
+        glm::vec2 size { 0.0f };
+    };
+
+    /// Signed distance field font. The glyphs of a codepoint range are rasterized once from a ttf into a
+    /// single-channel atlas, which stays sharp at any scale when drawn with renderer2d::draw_string
+    class MOON_API font
+    {
+    public:
+        explicit font(std::string_view path, const font_spec& spec = {});
+        ~font();
+
+        font(const font&) = delete;
+        font& operator=(const font&) = delete;
+
+        [[nodiscard]] bool is_loaded() const { return m_atlas_ != nullptr; }
+        [[nodiscard]] const ref<texture2d>& get_atlas() const { return m_atlas_; }
+        [[nodiscard]] const font_spec& get_spec() const { return m_spec_; }
+        [[nodiscard]] float get_line_height() const { return m_line_height_; }
+
+        /// nullptr for codepoints outside the baked range
+        [[nodiscard]] const glyph* get_glyph(uint32_t codepoint) const;
+
+        /// Lays out utf-8 text with kerning and '\n' line breaks. Layouts are cached by string, so static
+        /// labels are laid out once; the cache is dropped whole once it holds max_cached_layouts strings
+        ref<const text_layout> layout(std::string_view text);
+        [[nodiscard]] text_layout layout_uncached(std::string_view text) const;
+
+        static constexpr size_t max_cached_layouts = 1024;
+
+    private:
+        /// Checks the mounted archives before the loose file, like shaders and textures do
+        bool read_file();
+        void bake();
+
+    private:
+        struct string_hash
+        {
+            using is_transparent = void;
+            size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+        };
+
+        std::string m_path_;
+        font_spec m_spec_;
+
+        // stb_truetype reads kerning straight from the file data
+        std::vector<uint8_t> m_file_data_;
+        scope<stbtt_fontinfo> m_info_;
+        float m_scale_ = 0.0f;
+
+        ref<texture2d> m_atlas_;
+        std::vector<glyph> m_glyphs_;
+        std::vector<bool> m_has_glyph_;
+        float m_line_height_ = 0.0f;
+
+        std::unordered_map<std::string, ref<const text_layout>, string_hash, std::equal_to<>> m_layout_cache_;
+    };
+}
@@ -22,7 +22,11 @@ namespace moon
         ortho_camera& get_camera() { return camera_; }
         const ortho_camera& get_camera() const { return camera_; }
 
-        void set_zoom_level(float level) { zoom_level_ = level; }
+        void set_zoom_level(float level)
+        {
+            zoom_level_ = level;
+            camera_.set_projection(-aspect_ratio_ * zoom_level_, aspect_ratio_ * zoom_level_, -zoom_level_, zoom_level_);
+        }
         float get_zoom_level() const { return zoom_level_; }
     private:
         float aspect_ratio_;
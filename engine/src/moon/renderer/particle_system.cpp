@@ -0,0 +1,223 @@
+#include "moonpch.h"
+#include "particle_system.h"
+
+#include "moon/renderer/renderer2d.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <chrono>
+
+namespace moon
+{
+    void particle_pool::resize(uint32_t capacity)
+    {
+        for (std::vector<float>* attribute : { &position_x, &position_y, &velocity_x, &velocity_y, &rotation, &angular_velocity,
+            &age, &age_rate, &size_begin, &size_delta, &color_begin_r, &color_begin_g, &color_begin_b, &color_begin_a,
+            &color_delta_r, &color_delta_g, &color_delta_b, &color_delta_a })
+        {
+            attribute->resize(capacity);
+        }
+
+        count = std::min(count, capacity);
+    }
+
+    void particle_pool::swap_remove(uint32_t index)
+    {
+        const uint32_t last = --count;
+        if (index == last)
+            return;
+
+        position_x[index] = position_x[last];
+        position_y[index] = position_y[last];
+        velocity_x[index] = velocity_x[last];
+        velocity_y[index] = velocity_y[last];
+        rotation[index] = rotation[last];
+        angular_velocity[index] = angular_velocity[last];
+        age[index] = age[last];
+        age_rate[index] = age_rate[last];
+        size_begin[index] = size_begin[last];
+        size_delta[index] = size_delta[last];
+        color_begin_r[index] = color_begin_r[last];
+        color_begin_g[index] = color_begin_g[last];
+        color_begin_b[index] = color_begin_b[last];
+        color_begin_a[index] = color_begin_a[last];
+        color_delta_r[index] = color_delta_r[last];
+        color_delta_g[index] = color_delta_g[last];
+        color_delta_b[index] = color_delta_b[last];
+        color_delta_a[index] = color_delta_a[last];
+    }
+
+    particle_system::particle_system(uint32_t max_particles)
+    {
+        m_pool_.resize(max_particles);
+        m_stats_.capacity = max_particles;
+    }
+
+    particle_emitter_handle particle_system::create_emitter(const particle_props& props, float rate)
+    {
+        uint32_t index;
+        if (!m_free_emitters_.empty())
+        {
+            index = m_free_emitters_.back();
+            m_free_emitters_.pop_back();
+        }
+        else
+        {
+            index = (uint32_t)m_emitters_.size();
+            m_emitters_.emplace_back();
+        }
+
+        emitter_slot& slot = m_emitters_[index];
+        slot.emitter = { props, rate, true };
+        slot.accumulator = 0.0f;
+        slot.alive = true;
+        m_stats_.emitters++;
+
+        return { index, slot.generation };
+    }
+
+    void particle_system::destroy_emitter(particle_emitter_handle handle)
+    {
+        if (!get_emitter(handle))
+            return;
+
+        emitter_slot& slot = m_emitters_[handle.index];
+        slot.alive = false;
+        slot.generation++;
+        m_free_emitters_.push_back(handle.index);
+        m_stats_.emitters--;
+    }
+
+    particle_emitter* particle_system::get_emitter(particle_emitter_handle handle)
+    {
+        if (handle.index >= m_emitters_.size())
+            return nullptr;
+
+        emitter_slot& slot = m_emitters_[handle.index];
+        if (!slot.alive || slot.generation != handle.generation)
+            return nullptr;
+        return &slot.emitter;
+    }
+
+    float particle_system::random_float()
+    {
+        // xorshift32, plenty for visual noise and far cheaper than <random> per particle
+        m_random_state_ ^= m_random_state_ << 13;
+        m_random_state_ ^= m_random_state_ >> 17;
+        m_random_state_ ^= m_random_state_ << 5;
+        return (float)(m_random_state_ >> 8) * (1.0f / 16777216.0f);
+    }
+
+    void particle_system::emit(const particle_props& props, uint32_t count)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        particle_pool& p = m_pool_;
+        const uint32_t emitted = std::min(count, p.get_capacity() - p.count);
+        m_emitted_ += emitted;
+        m_dropped_ += count - emitted;
+
+        const float age_rate = 1.0f / std::max(props.life_time, 0.0001f);
+        const glm::vec4 color_delta = props.color_end - props.color_begin;
+        for (uint32_t n = 0; n < emitted; n++)
+        {
+            const uint32_t i = p.count++;
+
+            p.position_x[i] = props.position.x;
+            p.position_y[i] = props.position.y;
+            p.velocity_x[i] = props.velocity.x + props.velocity_variation.x * (random_float() - 0.5f);
+            p.velocity_y[i] = props.velocity.y + props.velocity_variation.y * (random_float() - 0.5f);
+            p.rotation[i] = random_float() * 2.0f * glm::pi<float>();
+            p.angular_velocity[i] = props.angular_velocity * (random_float() * 2.0f - 1.0f);
+            p.age[i] = 0.0f;
+            p.age_rate[i] = age_rate;
+
+            const float size = props.size_begin + props.size_variation * (random_float() - 0.5f);
+            p.size_begin[i] = size;
+            p.size_delta[i] = props.size_end - size;
+
+            p.color_begin_r[i] = props.color_begin.r;
+            p.color_begin_g[i] = props.color_begin.g;
+            p.color_begin_b[i] = props.color_begin.b;
+            p.color_begin_a[i] = props.color_begin.a;
+            p.color_delta_r[i] = color_delta.r;
+            p.color_delta_g[i] = color_delta.g;
+            p.color_delta_b[i] = color_delta.b;
+            p.color_delta_a[i] = color_delta.a;
+        }
+    }
+
+    void particle_system::on_update(timestep ts)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        const auto start = std::chrono::steady_clock::now();
+        const float dt = ts;
+
+        for (emitter_slot& slot : m_emitters_)
+        {
+            if (!slot.alive || !slot.emitter.enabled)
+                continue;
+
+            slot.accumulator += slot.emitter.rate * dt;
+            const uint32_t count = (uint32_t)slot.accumulator;
+            slot.accumulator -= (float)count;
+            if (count)
+                emit(slot.emitter.props, count);
+        }
+
+        {
+            MOON_PROFILE_SCOPE("particle_system::integrate");
+
+            // branch-free loops over separate arrays, so each one compiles to packed simd
+            const uint32_t count = m_pool_.count;
+            float* __restrict position_x = m_pool_.position_x.data();
+            float* __restrict position_y = m_pool_.position_y.data();
+            float* __restrict velocity_x = m_pool_.velocity_x.data();
+            float* __restrict velocity_y = m_pool_.velocity_y.data();
+            float* __restrict rotation = m_pool_.rotation.data();
+            const float* __restrict angular_velocity = m_pool_.angular_velocity.data();
+            float* __restrict age = m_pool_.age.data();
+            const float* __restrict age_rate = m_pool_.age_rate.data();
+
+            const float gravity_x = m_gravity_.x * dt;
+            const float gravity_y = m_gravity_.y * dt;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                velocity_x[i] += gravity_x;
+                velocity_y[i] += gravity_y;
+                position_x[i] += velocity_x[i] * dt;
+                position_y[i] += velocity_y[i] * dt;
+            }
+            for (uint32_t i = 0; i < count; i++)
+                rotation[i] += angular_velocity[i] * dt;
+            for (uint32_t i = 0; i < count; i++)
+                age[i] += age_rate[i] * dt;
+        }
+
+        {
+            MOON_PROFILE_SCOPE("particle_system::compact");
+
+            for (uint32_t i = 0; i < m_pool_.count;)
+            {
+                // the swapped-in particle is checked on the next iteration
+                if (m_pool_.age[i] >= 1.0f)
+                    m_pool_.swap_remove(i);
+                else
+                    i++;
+            }
+        }
+
+        m_stats_.live_particles = m_pool_.count;
+        m_stats_.emitted = m_emitted_;
+        m_stats_.dropped = m_dropped_;
+        m_stats_.update_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        m_emitted_ = 0;
+        m_dropped_ = 0;
+    }
+
+    void particle_system::on_render() const
+    {
+        renderer2d::draw_particles(m_pool_);
+    }
+}
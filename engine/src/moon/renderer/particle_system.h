@@ -0,0 +1,121 @@
+#pragma once
+
+#include "moon/core/core.h"
+#include "moon/core/timestep.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace moon
+{
+    struct particle_props
+    {
+        glm::vec2 position { 0.0f };
+        glm::vec2 velocity { 0.0f };
+        /// Full range of the random offset added to the velocity, centered on it
+        glm::vec2 velocity_variation { 0.0f };
+        glm::vec4 color_begin { 1.0f };
+        glm::vec4 color_end { 1.0f, 1.0f, 1.0f, 0.0f };
+        float size_begin = 0.1f;
+        float size_end = 0.0f;
+        float size_variation = 0.0f;
+        /// Radians per second, randomized in [-angular_velocity, angular_velocity]
+        float angular_velocity = 0.0f;
+        float life_time = 1.0f;
+    };
+
+    /// Particles as parallel arrays, one per attribute, so the update runs as straight loops over floats
+    /// the compiler vectorizes. Dead particles are swapped with the last live one, live particles stay packed
+    /// at the front, and colors and sizes are interpolated over age when drawn
+    struct particle_pool
+    {
+        std::vector<float> position_x, position_y;
+        std::vector<float> velocity_x, velocity_y;
+        std::vector<float> rotation, angular_velocity;
+        /// 0 when emitted, the particle dies at 1
+        std::vector<float> age, age_rate;
+        std::vector<float> size_begin, size_delta;
+        std::vector<float> color_begin_r, color_begin_g, color_begin_b, color_begin_a;
+        std::vector<float> color_delta_r, color_delta_g, color_delta_b, color_delta_a;
+
+        uint32_t count = 0;
+
+        void resize(uint32_t capacity);
+        [[nodiscard]] uint32_t get_capacity() const { return (uint32_t)age.size(); }
+        void swap_remove(uint32_t index);
+    };
+
+    struct particle_emitter_handle
+    {
+        uint32_t index = ~0u;
+        uint32_t generation = 0;
+
+        [[nodiscard]] bool is_valid() const { return index != ~0u; }
+    };
+
+    struct particle_emitter
+    {
+        particle_props props;
+        float rate = 0.0f; // particles per second
+        bool enabled = true;
+    };
+
+    struct particle_system_stats
+    {
+        uint32_t live_particles = 0;
+        uint32_t capacity = 0;
+        uint32_t emitters = 0;
+        uint32_t emitted = 0; // since the previous update
+        uint32_t dropped = 0; // since the previous update, emitted into a full pool
+        float update_ms = 0.0f;
+    };
+
+    /// Fixed-capacity particle simulation drawn through renderer2d::draw_particles. Emitters live in a pool
+    /// with a free list, handles carry a generation so a stale handle never reaches a recycled slot
+    class MOON_API particle_system
+    {
+    public:
+        explicit particle_system(uint32_t max_particles = 100000);
+
+        particle_emitter_handle create_emitter(const particle_props& props, float rate);
+        void destroy_emitter(particle_emitter_handle handle);
+        /// nullptr once the emitter is destroyed
+        particle_emitter* get_emitter(particle_emitter_handle handle);
+
+        /// One-off burst; whatever doesn't fit into the pool is dropped
+        void emit(const particle_props& props, uint32_t count = 1);
+
+        void on_update(timestep ts);
+        void on_render() const;
+
+        void clear() { m_pool_.count = 0; }
+
+        void set_gravity(const glm::vec2& gravity) { m_gravity_ = gravity; }
+        [[nodiscard]] const particle_pool& get_pool() const { return m_pool_; }
+        [[nodiscard]] const particle_system_stats& get_stats() const { return m_stats_; }
+
+    private:
+        float random_float();
+
+    private:
+        struct emitter_slot
+        {
+            particle_emitter emitter;
+            float accumulator = 0.0f;
+            uint32_t generation = 0;
+            bool alive = false;
+        };
+
+        particle_pool m_pool_;
+        glm::vec2 m_gravity_ { 0.0f };
+
+        std::vector<emitter_slot> m_emitters_;
+        std::vector<uint32_t> m_free_emitters_;
+
+        uint32_t m_random_state_ = 0x9e3779b9u;
+        // counted between updates, published to m_stats_ by on_update
+        uint32_t m_emitted_ = 0, m_dropped_ = 0;
+        particle_system_stats m_stats_;
+    };
+}
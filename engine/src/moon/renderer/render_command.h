@@ -20,6 +20,10 @@ namespace moon
         {
             s_renderer_api_->set_viewport(x, y, width, height);
         }
+        inline static glm::vec4 get_viewport()
+        {
+            return s_renderer_api_->get_viewport();
+        }
         inline static void set_clear_color(const glm::vec4& color)
         {
             s_renderer_api_->set_clear_color(color);
@@ -33,6 +37,24 @@ namespace moon
         {
             s_renderer_api_->draw_indexed(vertex_array, index_count);
         }
+        inline static void draw_indexed_instanced(const ref<vertex_array>& vertex_array, uint32_t index_count, uint32_t instance_count)
+        {
+            s_renderer_api_->draw_indexed_instanced(vertex_array, index_count, instance_count);
+        }
+        inline static void draw_lines(const ref<vertex_array>& vertex_array, uint32_t vertex_count)
+        {
+            s_renderer_api_->draw_lines(vertex_array, vertex_count);
+        }
+
+        inline static void set_line_width(float width)
+        {
+            s_renderer_api_->set_line_width(width);
+        }
+
+        inline static void set_depth_write(bool enabled)
+        {
+            s_renderer_api_->set_depth_write(enabled);
+        }
     private:
         static renderer_api* s_renderer_api_;
     };
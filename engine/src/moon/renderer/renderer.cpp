@@ -4,20 +4,48 @@
 #include "render_command.h"
 #include "camera.h"
 #include "shader.h"
+#include "buffer.h"
 #include "moon/renderer/renderer2d.h"
+#include "moon/renderer/texture_loader.h"
+#include "moon/renderer/texture_cache.h"
+#include "moon/asset/asset_watcher.h"
+#include "platform/opengl/opengl_program_cache.h"
+
+#include <chrono>
 
 namespace moon
 {
     renderer::scene_data* renderer::s_scene_data_ = nullptr;
 
+    static const auto s_renderer_start = std::chrono::steady_clock::now();
+
     void renderer::init()
     {
         MOON_PROFILE_FUNCTION();
 
+        const auto start = std::chrono::steady_clock::now();
+
         s_scene_data_ = new scene_data;
 
+        // before anything loads, so every shader and texture gets registered
+        asset_watcher::init();
         render_command::init();
+        s_scene_data_->camera_buffer = uniform_buffer::create(sizeof(camera_uniforms), camera_uniforms::binding);
         renderer2d::init();
+        texture_loader::init();
+
+        // dominated by shader compiles on a cold program cache
+        const float init_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (get_api() == renderer_api::API::OpenGL)
+        {
+            const program_cache_stats stats = opengl_program_cache::get_stats();
+            MOON_CORE_INFO("Renderer initialized in {0:.2f} ms (program cache: {1} hits loaded in {2:.2f} ms, {3} misses, {4} rejected)",
+                init_ms, stats.hits, stats.load_ms, stats.misses, stats.rejected);
+        }
+        else
+        {
+            MOON_CORE_INFO("Renderer initialized in {0:.2f} ms", init_ms);
+        }
     }
 
     void renderer::shutdown()
@@ -25,6 +53,10 @@ namespace moon
         MOON_PROFILE_FUNCTION();
 
         delete s_scene_data_;
+        asset_watcher::shutdown();
+        texture_loader::shutdown();
+        // cached textures must go before the context does
+        texture_cache::clear();
         renderer2d::shutdown();
     }
 
@@ -36,6 +68,7 @@ namespace moon
     void renderer::begin_scene(const ortho_camera& cam)
     {
         s_scene_data_->view_projection_matrix = cam.get_view_projection_matrix();
+        set_camera(cam.get_view_matrix(), cam.get_projection_matrix());
     }
 
     void renderer::end_scene()
@@ -44,10 +77,23 @@ namespace moon
     void renderer::submit(const ref<shader>& shader, const ref<vertex_array>& vertex_array, const glm::mat4& transform)
     {
         shader->bind();
-        shader->set_mat4("u_VP", s_scene_data_->view_projection_matrix);
         shader->set_mat4("u_Model", transform);
 
         vertex_array->bind();
         render_command::draw_indexed(vertex_array);
     }
+
+    void renderer::set_camera(const glm::mat4& view, const glm::mat4& projection)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        camera_uniforms camera {};
+        camera.view = view;
+        camera.projection = projection;
+        camera.view_projection = projection * view;
+        camera.viewport = render_command::get_viewport();
+        camera.time = std::chrono::duration<float>(std::chrono::steady_clock::now() - s_renderer_start).count();
+
+        s_scene_data_->camera_buffer->set_data(&camera, sizeof(camera));
+    }
 }
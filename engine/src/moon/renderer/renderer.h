@@ -8,6 +8,29 @@ namespace moon
 {
     class ortho_camera;
     class shader;
+    class uniform_buffer;
+
+    /// Mirrors the std140 Camera block every shader declares; opengl_shader checks the layout after linking:
+    ///
+    ///     layout(std140, binding = 0) uniform Camera
+    ///     {
+    ///         mat4 u_View;
+    ///         mat4 u_Projection;
+    ///         mat4 u_VP;
+    ///         vec4 u_Viewport; // x, y, width, height
+    ///         float u_Time;
+    ///     };
+    struct camera_uniforms
+    {
+        static constexpr uint32_t binding = 0;
+
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::mat4 view_projection;
+        glm::vec4 viewport;
+        float time;
+        float padding[3];
+    };
 
     class MOON_API renderer
     {
@@ -21,6 +44,9 @@ namespace moon
 
         static void submit(const ref<shader>& shader, const ref<vertex_array>& vertex_array, const glm::mat4& transform = glm::mat4(1.0f));
 
+        /// Uploads the camera block all shaders share, once per scene instead of once per shader
+        static void set_camera(const glm::mat4& view, const glm::mat4& projection);
+
         inline static renderer_api::API get_api() { return renderer_api::get_api(); }
         inline static const glm::mat4& get_view_projection_matrix() { return s_scene_data_->view_projection_matrix; }
 
@@ -28,6 +54,8 @@ namespace moon
         struct scene_data
         {
             glm::mat4 view_projection_matrix;
+
+            ref<uniform_buffer> camera_buffer;
         };
 
         static scene_data* s_scene_data_;
@@ -2,13 +2,17 @@
 #include "renderer2d.h"
 
 #include "render_command.h"
+#include "renderer.h"
 #include "moon/renderer/shader.h"
 #include "moon/renderer/buffer.h"
 #include "moon/renderer/vertex_array.h"
+#include "moon/renderer/particle_system.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <cmath>
+
 namespace moon
 {
     struct quad_vertex
@@ -20,6 +24,37 @@ namespace moon
         float tiling_factor;
     };
 
+    struct circle_vertex
+    {
+        glm::vec3 world_position;
+        glm::vec3 local_position; // -1..1 across the quad
+        glm::vec4 color;
+        float thickness;
+        float fade;
+    };
+
+    struct line_vertex
+    {
+        glm::vec3 position;
+        glm::vec4 color;
+    };
+
+    /// One per particle, the vertex shader expands it into a rotated square
+    struct particle_instance
+    {
+        glm::vec3 position;
+        float size;
+        float rotation;
+        uint32_t color; // rgba8
+    };
+
+    struct text_vertex
+    {
+        glm::vec3 position;
+        glm::vec4 color;
+        glm::vec2 tex_coords;
+    };
+
     struct renderer2d_data
     {
         static constexpr uint32_t max_quads = 20000;
@@ -29,8 +64,13 @@ namespace moon
 
         ref<vertex_array> quad_vertex_array;
         ref<vertex_buffer> quad_vertex_buffer;
+        shader_variants texture_shaders;
         ref<shader> texture_shader;
+        // batches that only use the white texture skip sampling entirely
+        ref<shader> color_shader;
         ref<texture2d> white_texture;
+        // every other batch's shader, compiled side by side with the texture variants
+        shader_library shaders;
 
         uint32_t quad_index_count = 0;
         quad_vertex* quad_vertex_buffer_base = nullptr;
@@ -39,6 +79,59 @@ namespace moon
         std::array<ref<texture2d>, max_texture_slots> texture_slots;
         uint32_t texture_slot_index = 1; // 0 = white texture
 
+        // texture array batch, same vertex layout with the layer in tex_index
+        ref<vertex_array> array_vertex_array;
+        ref<vertex_buffer> array_vertex_buffer;
+        ref<shader> texture_array_shader;
+        ref<texture2d_array> batch_texture_array;
+
+        uint32_t array_index_count = 0;
+        quad_vertex* array_vertex_buffer_base = nullptr;
+        quad_vertex* array_vertex_buffer_ptr = nullptr;
+
+        // circle batch, shares the quad index buffer
+        ref<vertex_array> circle_vertex_array;
+        ref<vertex_buffer> circle_vertex_buffer;
+        ref<shader> circle_shader;
+
+        uint32_t circle_index_count = 0;
+        circle_vertex* circle_vertex_buffer_base = nullptr;
+        circle_vertex* circle_vertex_buffer_ptr = nullptr;
+
+        // line batch, drawn unindexed as a line list
+        static constexpr uint32_t max_line_vertices = max_quads * 2;
+
+        ref<vertex_array> line_vertex_array;
+        ref<vertex_buffer> line_vertex_buffer;
+        ref<shader> line_shader;
+
+        uint32_t line_vertex_count = 0;
+        line_vertex* line_vertex_buffer_base = nullptr;
+        line_vertex* line_vertex_buffer_ptr = nullptr;
+
+        float line_width = 1.0f;
+
+        // particle batch, instanced so a million particles are one 24 MB upload and one draw
+        static constexpr uint32_t max_particle_instances = 1 << 20;
+
+        ref<vertex_array> particle_vertex_array;
+        ref<vertex_buffer> particle_instance_buffer;
+        ref<shader> particle_shader;
+
+        uint32_t particle_instance_count = 0;
+        particle_instance* particle_instance_buffer_base = nullptr;
+        particle_instance* particle_instance_buffer_ptr = nullptr;
+
+        // glyph batch, one font atlas at a time
+        ref<vertex_array> text_vertex_array;
+        ref<vertex_buffer> text_vertex_buffer;
+        ref<shader> text_shader;
+        ref<texture2d> batch_font_atlas;
+
+        uint32_t text_index_count = 0;
+        text_vertex* text_vertex_buffer_base = nullptr;
+        text_vertex* text_vertex_buffer_ptr = nullptr;
+
         glm::vec4 quad_vertex_positions[4];
 
         renderer2d::statistics stats;
@@ -88,6 +181,68 @@ namespace moon
         s_data.quad_vertex_array->set_index_buffer(quad_ib);
         delete[] quad_indices;
 
+        s_data.array_vertex_array = vertex_array::create();
+        s_data.array_vertex_buffer = vertex_buffer::create(s_data.max_vertices * sizeof(quad_vertex));
+        s_data.array_vertex_buffer->set_layout(s_data.quad_vertex_buffer->get_layout());
+        s_data.array_vertex_array->add_vertex_buffer(s_data.array_vertex_buffer);
+        s_data.array_vertex_array->set_index_buffer(quad_ib);
+        s_data.array_vertex_buffer_base = new quad_vertex[s_data.max_vertices];
+
+        s_data.circle_vertex_array = vertex_array::create();
+        s_data.circle_vertex_buffer = vertex_buffer::create(s_data.max_vertices * sizeof(circle_vertex));
+        s_data.circle_vertex_buffer->set_layout({
+            { ShaderDataType::Float3, "a_WorldPosition" },
+            { ShaderDataType::Float3, "a_LocalPosition" },
+            { ShaderDataType::Float4, "a_Color" },
+            { ShaderDataType::Float, "a_Thickness" },
+            { ShaderDataType::Float, "a_Fade" }
+        });
+        s_data.circle_vertex_array->add_vertex_buffer(s_data.circle_vertex_buffer);
+        s_data.circle_vertex_array->set_index_buffer(quad_ib);
+        s_data.circle_vertex_buffer_base = new circle_vertex[s_data.max_vertices];
+
+        s_data.line_vertex_array = vertex_array::create();
+        s_data.line_vertex_buffer = vertex_buffer::create(s_data.max_line_vertices * sizeof(line_vertex));
+        s_data.line_vertex_buffer->set_layout({
+            { ShaderDataType::Float3, "a_Position" },
+            { ShaderDataType::Float4, "a_Color" }
+        });
+        s_data.line_vertex_array->add_vertex_buffer(s_data.line_vertex_buffer);
+        s_data.line_vertex_buffer_base = new line_vertex[s_data.max_line_vertices];
+
+        s_data.particle_vertex_array = vertex_array::create();
+        // unit square shared by every instance, same winding as quad_vertex_positions
+        float particle_corners[4 * 2] = { -0.5f, -0.5f, 0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f };
+        ref<vertex_buffer> particle_corner_buffer = vertex_buffer::create(particle_corners, sizeof(particle_corners));
+        particle_corner_buffer->set_layout({
+            { ShaderDataType::Float2, "a_Corner" }
+        });
+        s_data.particle_vertex_array->add_vertex_buffer(particle_corner_buffer);
+
+        s_data.particle_instance_buffer = vertex_buffer::create(s_data.max_particle_instances * sizeof(particle_instance));
+        s_data.particle_instance_buffer->set_layout({
+            { ShaderDataType::Float3, "a_Position" },
+            { ShaderDataType::Float, "a_Size" },
+            { ShaderDataType::Float, "a_Rotation" },
+            { ShaderDataType::UByte4, "a_Color", true }
+        });
+        s_data.particle_vertex_array->add_instance_buffer(s_data.particle_instance_buffer);
+        s_data.particle_instance_buffer_base = new particle_instance[s_data.max_particle_instances];
+
+        uint32_t particle_indices[6] = { 0, 1, 2, 2, 3, 0 };
+        s_data.particle_vertex_array->set_index_buffer(index_buffer::create(particle_indices, 6));
+
+        s_data.text_vertex_array = vertex_array::create();
+        s_data.text_vertex_buffer = vertex_buffer::create(s_data.max_vertices * sizeof(text_vertex));
+        s_data.text_vertex_buffer->set_layout({
+            { ShaderDataType::Float3, "a_Position" },
+            { ShaderDataType::Float4, "a_Color" },
+            { ShaderDataType::Float2, "a_TexCoord" }
+        });
+        s_data.text_vertex_array->add_vertex_buffer(s_data.text_vertex_buffer);
+        s_data.text_vertex_array->set_index_buffer(quad_ib);
+        s_data.text_vertex_buffer_base = new text_vertex[s_data.max_vertices];
+
         // create a white shader used as a default texture
         s_data.white_texture = texture2d::create(1, 1);
         uint32_t white_texture_data = 0xffffffff;
@@ -99,11 +254,32 @@ namespace moon
             samplers[i] = (int32_t)i;
         }
 
-        // create our texture shader
-        s_data.texture_shader = shader::create("assets/shaders/texture.glsl");
+        // all are created before any is used, so the driver compiles them side by side
+        s_data.texture_shaders = shader_variants("assets/shaders/texture.glsl");
+        s_data.texture_shader = s_data.texture_shaders.get();
+        s_data.color_shader = s_data.texture_shaders.get({ "COLOR_ONLY" });
+        s_data.shaders.load_all({
+            "assets/shaders/texture_array.glsl",
+            "assets/shaders/circle.glsl",
+            "assets/shaders/line.glsl",
+            "assets/shaders/text.glsl",
+            "assets/shaders/particle.glsl"
+        });
+        s_data.texture_array_shader = s_data.shaders.get("texture_array");
+        s_data.circle_shader = s_data.shaders.get("circle");
+        s_data.line_shader = s_data.shaders.get("line");
+        s_data.text_shader = s_data.shaders.get("text");
+        s_data.particle_shader = s_data.shaders.get("particle");
+
         s_data.texture_shader->bind();
         s_data.texture_shader->set_int_array("u_Textures", samplers, s_data.max_texture_slots);
 
+        s_data.texture_array_shader->bind();
+        s_data.texture_array_shader->set_int("u_TextureArray", 0);
+
+        s_data.text_shader->bind();
+        s_data.text_shader->set_int("u_FontAtlas", 0);
+
         // set index 0 to white texture
         s_data.texture_slots[0] = s_data.white_texture;
 
@@ -117,35 +293,73 @@ namespace moon
     {
         MOON_PROFILE_FUNCTION();
 
-
+        delete[] s_data.quad_vertex_buffer_base;
+        delete[] s_data.array_vertex_buffer_base;
+        delete[] s_data.circle_vertex_buffer_base;
+        delete[] s_data.line_vertex_buffer_base;
+        delete[] s_data.text_vertex_buffer_base;
+        delete[] s_data.particle_instance_buffer_base;
+        s_data.quad_vertex_buffer_base = nullptr;
+        s_data.array_vertex_buffer_base = nullptr;
+        s_data.circle_vertex_buffer_base = nullptr;
+        s_data.line_vertex_buffer_base = nullptr;
+        s_data.text_vertex_buffer_base = nullptr;
+        s_data.particle_instance_buffer_base = nullptr;
     }
 
     void renderer2d::begin_scene(const camera& camera, const glm::mat4& transform)
     {
         MOON_PROFILE_FUNCTION();
 
-        glm::mat4 view_proj = camera.get_projection() * glm::inverse(transform);
-
-        s_data.texture_shader->bind();
-        s_data.texture_shader->set_mat4("u_VP", view_proj);
+        // every batch shader reads the camera block, no per-shader uploads
+        renderer::set_camera(glm::inverse(transform), camera.get_projection());
 
         s_data.quad_index_count = 0;
         s_data.quad_vertex_buffer_ptr = s_data.quad_vertex_buffer_base;
 
         s_data.texture_slot_index = 1;
+
+        s_data.array_index_count = 0;
+        s_data.array_vertex_buffer_ptr = s_data.array_vertex_buffer_base;
+
+        s_data.circle_index_count = 0;
+        s_data.circle_vertex_buffer_ptr = s_data.circle_vertex_buffer_base;
+
+        s_data.line_vertex_count = 0;
+        s_data.line_vertex_buffer_ptr = s_data.line_vertex_buffer_base;
+
+        s_data.text_index_count = 0;
+        s_data.text_vertex_buffer_ptr = s_data.text_vertex_buffer_base;
+
+        s_data.particle_instance_count = 0;
+        s_data.particle_instance_buffer_ptr = s_data.particle_instance_buffer_base;
     }
 
     void renderer2d::begin_scene(const ortho_camera& camera)
     {
         MOON_PROFILE_FUNCTION();
 
-        s_data.texture_shader->bind();
-        s_data.texture_shader->set_mat4("u_VP", camera.get_view_projection_matrix());
+        renderer::set_camera(camera.get_view_matrix(), camera.get_projection_matrix());
 
         s_data.quad_index_count = 0;
         s_data.quad_vertex_buffer_ptr = s_data.quad_vertex_buffer_base;
 
         s_data.texture_slot_index = 1;
+
+        s_data.array_index_count = 0;
+        s_data.array_vertex_buffer_ptr = s_data.array_vertex_buffer_base;
+
+        s_data.circle_index_count = 0;
+        s_data.circle_vertex_buffer_ptr = s_data.circle_vertex_buffer_base;
+
+        s_data.line_vertex_count = 0;
+        s_data.line_vertex_buffer_ptr = s_data.line_vertex_buffer_base;
+
+        s_data.text_index_count = 0;
+        s_data.text_vertex_buffer_ptr = s_data.text_vertex_buffer_base;
+
+        s_data.particle_instance_count = 0;
+        s_data.particle_instance_buffer_ptr = s_data.particle_instance_buffer_base;
     }
 
     void renderer2d::end_scene()
@@ -156,22 +370,148 @@ namespace moon
         s_data.quad_vertex_buffer->set_data(s_data.quad_vertex_buffer_base, data_size);
 
         flush();
+        flush_array_batch();
+        flush_circle_batch();
+        flush_line_batch();
+        flush_particle_batch();
+        flush_text_batch();
     }
 
     void renderer2d::flush()
     {
         MOON_PROFILE_FUNCTION();
 
-        // bind textures
-        for (uint32_t i = 0; i < s_data.texture_slot_index; i++)
+        // draw_indexed treats a count of 0 as the whole index buffer
+        if (s_data.quad_index_count == 0)
+            return;
+
+        if (s_data.texture_slot_index == 1)
         {
-            s_data.texture_slots[i]->bind(i);
+            s_data.color_shader->bind();
+            s_data.stats.color_only_draw_calls++;
+        }
+        else
+        {
+            // bind textures
+            for (uint32_t i = 0; i < s_data.texture_slot_index; i++)
+            {
+                s_data.texture_slots[i]->bind(i);
+            }
+
+            s_data.texture_shader->bind();
+            s_data.stats.texture_binds += s_data.texture_slot_index;
         }
 
+        s_data.quad_vertex_array->bind();
         render_command::draw_indexed(s_data.quad_vertex_array, s_data.quad_index_count);
         s_data.stats.draw_calls++;
     }
 
+    void renderer2d::flush_array_batch()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        if (s_data.array_index_count == 0)
+            return;
+
+        uint32_t data_size = (uint32_t)((uint8_t*)s_data.array_vertex_buffer_ptr - (uint8_t*)s_data.array_vertex_buffer_base);
+        s_data.array_vertex_buffer->set_data(s_data.array_vertex_buffer_base, data_size);
+
+        s_data.batch_texture_array->bind(0);
+        s_data.texture_array_shader->bind();
+        s_data.array_vertex_array->bind();
+        render_command::draw_indexed(s_data.array_vertex_array, s_data.array_index_count);
+
+        s_data.stats.draw_calls++;
+        s_data.stats.texture_binds++;
+
+        s_data.array_index_count = 0;
+        s_data.array_vertex_buffer_ptr = s_data.array_vertex_buffer_base;
+    }
+
+    void renderer2d::flush_circle_batch()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        if (s_data.circle_index_count == 0)
+            return;
+
+        uint32_t data_size = (uint32_t)((uint8_t*)s_data.circle_vertex_buffer_ptr - (uint8_t*)s_data.circle_vertex_buffer_base);
+        s_data.circle_vertex_buffer->set_data(s_data.circle_vertex_buffer_base, data_size);
+
+        s_data.circle_shader->bind();
+        s_data.circle_vertex_array->bind();
+        render_command::draw_indexed(s_data.circle_vertex_array, s_data.circle_index_count);
+        s_data.stats.draw_calls++;
+
+        s_data.circle_index_count = 0;
+        s_data.circle_vertex_buffer_ptr = s_data.circle_vertex_buffer_base;
+    }
+
+    void renderer2d::flush_line_batch()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        if (s_data.line_vertex_count == 0)
+            return;
+
+        uint32_t data_size = (uint32_t)((uint8_t*)s_data.line_vertex_buffer_ptr - (uint8_t*)s_data.line_vertex_buffer_base);
+        s_data.line_vertex_buffer->set_data(s_data.line_vertex_buffer_base, data_size);
+
+        s_data.line_shader->bind();
+        s_data.line_vertex_array->bind();
+        render_command::set_line_width(s_data.line_width);
+        render_command::draw_lines(s_data.line_vertex_array, s_data.line_vertex_count);
+        s_data.stats.draw_calls++;
+
+        s_data.line_vertex_count = 0;
+        s_data.line_vertex_buffer_ptr = s_data.line_vertex_buffer_base;
+    }
+
+    void renderer2d::flush_particle_batch()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        if (s_data.particle_instance_count == 0)
+            return;
+
+        uint32_t data_size = (uint32_t)((uint8_t*)s_data.particle_instance_buffer_ptr - (uint8_t*)s_data.particle_instance_buffer_base);
+        s_data.particle_instance_buffer->set_data(s_data.particle_instance_buffer_base, data_size);
+
+        s_data.particle_shader->bind();
+        s_data.particle_vertex_array->bind();
+        // particles overlap at one depth, so they blend over each other instead of failing the depth test
+        render_command::set_depth_write(false);
+        render_command::draw_indexed_instanced(s_data.particle_vertex_array, 6, s_data.particle_instance_count);
+        render_command::set_depth_write(true);
+        s_data.stats.draw_calls++;
+
+        s_data.particle_instance_count = 0;
+        s_data.particle_instance_buffer_ptr = s_data.particle_instance_buffer_base;
+    }
+
+    void renderer2d::flush_text_batch()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        if (s_data.text_index_count == 0)
+            return;
+
+        uint32_t data_size = (uint32_t)((uint8_t*)s_data.text_vertex_buffer_ptr - (uint8_t*)s_data.text_vertex_buffer_base);
+        s_data.text_vertex_buffer->set_data(s_data.text_vertex_buffer_base, data_size);
+
+        s_data.batch_font_atlas->bind(0);
+        s_data.text_shader->bind();
+        s_data.text_vertex_array->bind();
+        render_command::draw_indexed(s_data.text_vertex_array, s_data.text_index_count);
+
+        s_data.stats.draw_calls++;
+        s_data.stats.texture_binds++;
+
+        s_data.text_index_count = 0;
+        s_data.text_vertex_buffer_ptr = s_data.text_vertex_buffer_base;
+    }
+
     void renderer2d::flush_and_reset()
     {
         end_scene();
@@ -356,6 +696,60 @@ namespace moon
         s_data.stats.quad_count++;
     }
 
+    void renderer2d::draw_quad(const glm::vec2& position, const glm::vec2& size, const ref<texture2d_array>& texture_array,
+        uint32_t layer, float tiling_factor, const glm::vec4& tint_color)
+    {
+        draw_quad({ position.x, position.y, 0.0f }, size, texture_array, layer, tiling_factor, tint_color);
+    }
+
+    void renderer2d::draw_quad(const glm::vec3& position, const glm::vec2& size, const ref<texture2d_array>& texture_array,
+        uint32_t layer, float tiling_factor, const glm::vec4& tint_color)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        glm::mat4 transform = glm::mat4(1.0f);
+        transform = glm::translate(transform, position)
+            * glm::scale(transform, glm::vec3(size, 1.0f));
+
+        draw_quad(transform, texture_array, layer, tiling_factor, tint_color);
+    }
+
+    void renderer2d::draw_quad(const glm::mat4& transform, const ref<texture2d_array>& texture_array, uint32_t layer,
+        float tiling_factor, const glm::vec4& tint_color)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        MOON_CORE_ASSERT(layer < texture_array->get_layer_count(), "Layer out of range!");
+
+        // one array per batch, but no slot limit within it
+        if (s_data.array_index_count >= renderer2d_data::max_indices
+            || (s_data.batch_texture_array && !(*s_data.batch_texture_array == *texture_array)))
+            flush_array_batch();
+        s_data.batch_texture_array = texture_array;
+
+        constexpr size_t quad_vertex_count = 4;
+        constexpr glm::vec2 texture_coords[4] = {
+            {0.0f, 0.0f},
+            {1.0f, 0.0f},
+            {1.0f, 1.0f},
+            {0.0f, 1.0f}
+        };
+
+        for (size_t i = 0; i < quad_vertex_count; i++)
+        {
+            s_data.array_vertex_buffer_ptr->position = transform * s_data.quad_vertex_positions[i];
+            s_data.array_vertex_buffer_ptr->color = tint_color;
+            s_data.array_vertex_buffer_ptr->tex_coords = texture_coords[i];
+            s_data.array_vertex_buffer_ptr->tex_index = (float)layer;
+            s_data.array_vertex_buffer_ptr->tiling_factor = tiling_factor;
+            s_data.array_vertex_buffer_ptr++;
+        }
+
+        s_data.array_index_count += 6;
+
+        s_data.stats.quad_count++;
+    }
+
     void renderer2d::draw_rotated_quad(const glm::vec2& position, const glm::vec2& size, float rotation,
                                        const glm::vec4& color)
     {
@@ -523,6 +917,214 @@ namespace moon
         s_data.stats.quad_count++;
     }
 
+    void renderer2d::draw_circle(const glm::vec2& position, float radius, const glm::vec4& color, float thickness, float fade)
+    {
+        draw_circle({ position.x, position.y, 0.0f }, radius, color, thickness, fade);
+    }
+
+    void renderer2d::draw_circle(const glm::vec3& position, float radius, const glm::vec4& color, float thickness, float fade)
+    {
+        glm::mat4 transform = glm::mat4(1.0f);
+        transform = glm::translate(transform, position)
+            * glm::scale(transform, glm::vec3(radius * 2.0f, radius * 2.0f, 1.0f));
+
+        draw_circle(transform, color, thickness, fade);
+    }
+
+    void renderer2d::draw_circle(const glm::mat4& transform, const glm::vec4& color, float thickness, float fade)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        if (s_data.circle_index_count >= renderer2d_data::max_indices)
+            flush_circle_batch();
+
+        constexpr size_t quad_vertex_count = 4;
+        for (size_t i = 0; i < quad_vertex_count; i++)
+        {
+            s_data.circle_vertex_buffer_ptr->world_position = transform * s_data.quad_vertex_positions[i];
+            s_data.circle_vertex_buffer_ptr->local_position = glm::vec3(s_data.quad_vertex_positions[i]) * 2.0f;
+            s_data.circle_vertex_buffer_ptr->color = color;
+            s_data.circle_vertex_buffer_ptr->thickness = thickness;
+            s_data.circle_vertex_buffer_ptr->fade = fade;
+            s_data.circle_vertex_buffer_ptr++;
+        }
+
+        s_data.circle_index_count += 6;
+
+        s_data.stats.circle_count++;
+    }
+
+    void renderer2d::draw_line(const glm::vec3& p0, const glm::vec3& p1, const glm::vec4& color)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        if (s_data.line_vertex_count >= renderer2d_data::max_line_vertices)
+            flush_line_batch();
+
+        s_data.line_vertex_buffer_ptr->position = p0;
+        s_data.line_vertex_buffer_ptr->color = color;
+        s_data.line_vertex_buffer_ptr++;
+
+        s_data.line_vertex_buffer_ptr->position = p1;
+        s_data.line_vertex_buffer_ptr->color = color;
+        s_data.line_vertex_buffer_ptr++;
+
+        s_data.line_vertex_count += 2;
+
+        s_data.stats.line_count++;
+    }
+
+    void renderer2d::draw_rect(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color)
+    {
+        const glm::vec3 p0 = { position.x - size.x * 0.5f, position.y - size.y * 0.5f, position.z };
+        const glm::vec3 p1 = { position.x + size.x * 0.5f, position.y - size.y * 0.5f, position.z };
+        const glm::vec3 p2 = { position.x + size.x * 0.5f, position.y + size.y * 0.5f, position.z };
+        const glm::vec3 p3 = { position.x - size.x * 0.5f, position.y + size.y * 0.5f, position.z };
+
+        draw_line(p0, p1, color);
+        draw_line(p1, p2, color);
+        draw_line(p2, p3, color);
+        draw_line(p3, p0, color);
+    }
+
+    void renderer2d::draw_rect(const glm::mat4& transform, const glm::vec4& color)
+    {
+        glm::vec3 corners[4];
+        for (size_t i = 0; i < 4; i++)
+            corners[i] = transform * s_data.quad_vertex_positions[i];
+
+        draw_line(corners[0], corners[1], color);
+        draw_line(corners[1], corners[2], color);
+        draw_line(corners[2], corners[3], color);
+        draw_line(corners[3], corners[0], color);
+    }
+
+    void renderer2d::draw_string(std::string_view text, const ref<font>& font, const glm::vec3& position, float size,
+        const glm::vec4& color)
+    {
+        glm::mat4 transform = glm::mat4(1.0f);
+        transform = glm::translate(transform, position)
+            * glm::scale(transform, glm::vec3(size, size, 1.0f));
+
+        draw_string(text, font, transform, color);
+    }
+
+    void renderer2d::draw_string(std::string_view text, const ref<font>& font, const glm::mat4& transform,
+        const glm::vec4& color)
+    {
+        if (!font->is_loaded())
+            return;
+
+        draw_string(*font->layout(text), font, transform, color);
+    }
+
+    void renderer2d::draw_string(const text_layout& layout, const ref<font>& font, const glm::mat4& transform,
+        const glm::vec4& color)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        const ref<texture2d>& atlas = font->get_atlas();
+        if (!atlas)
+            return;
+
+        if (s_data.batch_font_atlas && !(*s_data.batch_font_atlas == *atlas))
+            flush_text_batch();
+        s_data.batch_font_atlas = atlas;
+
+        for (const text_layout::quad& q : layout.quads)
+        {
+            if (s_data.text_index_count >= renderer2d_data::max_indices)
+                flush_text_batch();
+
+            const glm::vec4 corners[4] = {
+                { q.min.x, q.min.y, 0.0f, 1.0f },
+                { q.max.x, q.min.y, 0.0f, 1.0f },
+                { q.max.x, q.max.y, 0.0f, 1.0f },
+                { q.min.x, q.max.y, 0.0f, 1.0f }
+            };
+            const glm::vec2 texture_coords[4] = {
+                { q.uv_min.x, q.uv_min.y },
+                { q.uv_max.x, q.uv_min.y },
+                { q.uv_max.x, q.uv_max.y },
+                { q.uv_min.x, q.uv_max.y }
+            };
+
+            for (size_t i = 0; i < 4; i++)
+            {
+                s_data.text_vertex_buffer_ptr->position = transform * corners[i];
+                s_data.text_vertex_buffer_ptr->color = color;
+                s_data.text_vertex_buffer_ptr->tex_coords = texture_coords[i];
+                s_data.text_vertex_buffer_ptr++;
+            }
+
+            s_data.text_index_count += 6;
+        }
+
+        s_data.stats.glyph_count += (uint32_t)layout.quads.size();
+    }
+
+    static uint32_t pack_color(float r, float g, float b, float a)
+    {
+        const auto to_byte = [](float v) { return (uint32_t)(std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f); };
+        return to_byte(r) | to_byte(g) << 8 | to_byte(b) << 16 | to_byte(a) << 24;
+    }
+
+    void renderer2d::draw_particles(const particle_pool& pool, float depth)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        for (uint32_t first = 0; first < pool.count;)
+        {
+            if (s_data.particle_instance_count >= renderer2d_data::max_particle_instances)
+                flush_particle_batch();
+
+            // straight from the pool's arrays into the batch; corners and rotation are left to the gpu
+            const uint32_t room = renderer2d_data::max_particle_instances - s_data.particle_instance_count;
+            const uint32_t last = std::min(pool.count, first + room);
+
+            particle_instance* instance = s_data.particle_instance_buffer_ptr;
+            for (uint32_t i = first; i < last; i++)
+            {
+                const float t = pool.age[i];
+                instance->position = { pool.position_x[i], pool.position_y[i], depth };
+                instance->size = pool.size_begin[i] + pool.size_delta[i] * t;
+                instance->rotation = pool.rotation[i];
+                instance->color = pack_color(
+                    pool.color_begin_r[i] + pool.color_delta_r[i] * t,
+                    pool.color_begin_g[i] + pool.color_delta_g[i] * t,
+                    pool.color_begin_b[i] + pool.color_delta_b[i] * t,
+                    pool.color_begin_a[i] + pool.color_delta_a[i] * t);
+                instance++;
+            }
+
+            const uint32_t written = last - first;
+            s_data.particle_instance_buffer_ptr = instance;
+            s_data.particle_instance_count += written;
+            s_data.stats.particle_count += written;
+            first = last;
+        }
+    }
+
+    void renderer2d::set_line_width(float width)
+    {
+        // the whole line batch is drawn with one width, so a change ends the batch
+        if (width != s_data.line_width)
+            flush_line_batch();
+
+        s_data.line_width = width;
+    }
+
+    float renderer2d::get_line_width()
+    {
+        return s_data.line_width;
+    }
+
+    const ref<texture2d>& renderer2d::get_white_texture()
+    {
+        MOON_CORE_ASSERT(s_data.white_texture, "renderer2d isn't initialized!");
+        return s_data.white_texture;
+    }
+
     renderer2d::statistics renderer2d::get_stats()
     {
         return s_data.stats;
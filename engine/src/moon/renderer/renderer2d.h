@@ -5,9 +5,14 @@
 #include "moon/renderer/camera.h"
 #include "moon/renderer/texture.h"
 #include "moon/renderer/subtexture2d.h"
+#include "moon/renderer/font.h"
+
+#include <string_view>
 
 namespace moon
 {
+    struct particle_pool;
+
     class MOON_API renderer2d
     {
     public:
@@ -20,6 +25,9 @@ namespace moon
         static void end_scene();
         static void flush();
 
+        /// 1x1 white texture used for untextured quads and as the placeholder of pending texture loads
+        static const ref<texture2d>& get_white_texture();
+
         // primitives
         static void draw_quad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color);
         static void draw_quad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color);
@@ -28,6 +36,12 @@ namespace moon
         static void draw_quad(const glm::vec2& position, const glm::vec2& size, const ref<subtexture2d>& subtexture, float tiling_factor = 1.0f, const glm::vec4& tint_color = glm::vec4(1.0f));
         static void draw_quad(const glm::vec3& position, const glm::vec2& size, const ref<subtexture2d>& subtexture, float tiling_factor = 1.0f, const glm::vec4& tint_color = glm::vec4(1.0f));
 
+        /// Quads from texture arrays go into their own batch, one array at a time, and are drawn after the
+        /// slot-based batch, so order them by depth rather than by submission
+        static void draw_quad(const glm::vec2& position, const glm::vec2& size, const ref<texture2d_array>& texture_array, uint32_t layer, float tiling_factor = 1.0f, const glm::vec4& tint_color = glm::vec4(1.0f));
+        static void draw_quad(const glm::vec3& position, const glm::vec2& size, const ref<texture2d_array>& texture_array, uint32_t layer, float tiling_factor = 1.0f, const glm::vec4& tint_color = glm::vec4(1.0f));
+        static void draw_quad(const glm::mat4& transform, const ref<texture2d_array>& texture_array, uint32_t layer, float tiling_factor = 1.0f, const glm::vec4& tint_color = glm::vec4(1.0f));
+
         static void draw_quad(const glm::mat4& transform, const glm::vec4& color);
         static void draw_quad(const glm::mat4& transform, const ref<texture2d>& texture, float tiling_factor = 1.0f, const glm::vec4& tint_color = glm::vec4(1.0f));
 
@@ -39,18 +53,56 @@ namespace moon
         static void draw_rotated_quad(const glm::vec2& position, const glm::vec2& size, float rotation, const ref<subtexture2d>& subtexture, float tiling_factor = 1.0f, const glm::vec4& tint_color = glm::vec4(1.0f));
         static void draw_rotated_quad(const glm::vec3& position, const glm::vec2& size, float rotation, const ref<subtexture2d>& subtexture, float tiling_factor = 1.0f, const glm::vec4& tint_color = glm::vec4(1.0f));
 
+        /// Circles are quads shaded by distance to the rim. Thickness is 1 for a filled disc and goes down to a thin
+        /// ring, fade softens the edge; both are fractions of the radius. They get their own batch, drawn after quads.
+        static void draw_circle(const glm::vec2& position, float radius, const glm::vec4& color, float thickness = 1.0f, float fade = 0.005f);
+        static void draw_circle(const glm::vec3& position, float radius, const glm::vec4& color, float thickness = 1.0f, float fade = 0.005f);
+        static void draw_circle(const glm::mat4& transform, const glm::vec4& color, float thickness = 1.0f, float fade = 0.005f);
+
+        /// Lines are batched into a single line list per flush, drawn last
+        static void draw_line(const glm::vec3& p0, const glm::vec3& p1, const glm::vec4& color);
+        /// Outlined rectangle made of four lines
+        static void draw_rect(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color);
+        static void draw_rect(const glm::mat4& transform, const glm::vec4& color);
+
+        static void set_line_width(float width);
+        static float get_line_width();
+
+        /// Writes one instance per live particle of the pool into the particle batch, each drawn as a rotated,
+        /// colored square.
+        /// Particles don't write depth, so they blend over each other; they are drawn before text
+        static void draw_particles(const particle_pool& pool, float depth = 0.0f);
+
+        /// Text starts at the baseline of its first line; size is the height of a line in world units.
+        /// Layouts come from the font's cache, glyphs of one font batch together and are drawn after everything else
+        static void draw_string(std::string_view text, const ref<font>& font, const glm::vec3& position, float size, const glm::vec4& color = glm::vec4(1.0f));
+        static void draw_string(std::string_view text, const ref<font>& font, const glm::mat4& transform, const glm::vec4& color = glm::vec4(1.0f));
+        /// For callers that keep the layout of a label themselves
+        static void draw_string(const text_layout& layout, const ref<font>& font, const glm::mat4& transform, const glm::vec4& color = glm::vec4(1.0f));
+
         struct statistics
         {
             uint32_t draw_calls = 0;
             uint32_t quad_count = 0;
+            uint32_t texture_binds = 0; // summed over batches, an atlas keeps this near the page count
+            uint32_t color_only_draw_calls = 0; // batches drawn with the shader variant that samples nothing
+            uint32_t circle_count = 0;
+            uint32_t line_count = 0;
+            uint32_t glyph_count = 0;
+            uint32_t particle_count = 0;
 
-            uint32_t get_total_vertex_count() const { return quad_count * 4; }
-            uint32_t get_total_index_count() const { return quad_count * 6; }
+            uint32_t get_total_vertex_count() const { return (quad_count + circle_count + glyph_count + particle_count) * 4 + line_count * 2; }
+            uint32_t get_total_index_count() const { return (quad_count + circle_count + glyph_count + particle_count) * 6; }
         };
         static statistics get_stats();
         static void reset_stats();
 
     private:
         static void flush_and_reset();
+        static void flush_array_batch();
+        static void flush_circle_batch();
+        static void flush_line_batch();
+        static void flush_particle_batch();
+        static void flush_text_batch();
     };
 }
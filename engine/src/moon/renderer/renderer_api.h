@@ -20,11 +20,21 @@ namespace moon
 
         virtual void init() = 0;
         virtual void set_viewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
+        /// x, y, width, height of the current viewport, whoever set it
+        [[nodiscard]] virtual glm::vec4 get_viewport() const = 0;
 
         virtual void set_clear_color(const glm::vec4& color) = 0;
         virtual void clear() = 0;
 
         virtual void draw_indexed(const ref<vertex_array>& vertex_array, uint32_t index_count = 0) = 0;
+        /// Draws the indexed mesh instance_count times, instance buffers advance once per copy
+        virtual void draw_indexed_instanced(const ref<vertex_array>& vertex_array, uint32_t index_count, uint32_t instance_count) = 0;
+        /// Non-indexed line list, two vertices per segment
+        virtual void draw_lines(const ref<vertex_array>& vertex_array, uint32_t vertex_count) = 0;
+
+        virtual void set_line_width(float width) = 0;
+        /// Depth testing stays on, this only stops draws from occluding later ones (blended effects)
+        virtual void set_depth_write(bool enabled) = 0;
 
         static API get_api() { return s_API_; }
     private:
@@ -3,9 +3,19 @@
 
 #include "renderer.h"
 #include "platform/opengl/opengl_shader.h"
+#include "moon/asset/asset_watcher.h"
+#include "moon/renderer/shader_preprocessor.h"
 
 namespace moon
 {
+    /// Editing an included file reloads every shader that includes it
+    static void watch_shader_files(const ref<shader>& shader, std::string_view file_path)
+    {
+        asset_watcher::watch(shader, file_path);
+        for (const auto& include_path : shader->get_include_paths())
+            asset_watcher::watch(shader, include_path);
+    }
+
     ref<shader> shader::create(std::string_view file_path)
     {
         switch (renderer::get_api())
@@ -14,7 +24,30 @@ namespace moon
             MOON_CORE_ASSERT(false, "RendererAPI::None is not supported");
             return nullptr;
         case renderer_api::API::OpenGL:
-            return std::make_shared<opengl_shader>(file_path);
+        {
+            ref<shader> shader = std::make_shared<opengl_shader>(file_path);
+            watch_shader_files(shader, file_path);
+            return shader;
+        }
+        }
+
+        MOON_CORE_ASSERT(false, "Unknown RendererAPI!");
+        return nullptr;
+    }
+
+    ref<shader> shader::create(std::string_view file_path, std::vector<std::string> defines)
+    {
+        switch (renderer::get_api())
+        {
+        case renderer_api::API::None:
+            MOON_CORE_ASSERT(false, "RendererAPI::None is not supported");
+            return nullptr;
+        case renderer_api::API::OpenGL:
+        {
+            ref<shader> shader = std::make_shared<opengl_shader>(file_path, std::move(defines));
+            watch_shader_files(shader, file_path);
+            return shader;
+        }
         }
 
         MOON_CORE_ASSERT(false, "Unknown RendererAPI!");
@@ -36,10 +69,24 @@ namespace moon
         return nullptr;
     }
 
+    ref<shader> shader_variants::get(std::initializer_list<std::string_view> defines)
+    {
+        std::vector<std::string> define_list(defines.begin(), defines.end());
+        const std::string key = shader_preprocessor::make_permutation_key(define_list);
+
+        auto it = variants_.find(key);
+        if (it != variants_.end())
+            return it->second;
+
+        ref<shader> variant = shader::create(file_path_, std::move(define_list));
+        variants_.emplace(key, variant);
+        return variant;
+    }
+
     void shader_library::add(std::string_view name, const ref<shader>& shader)
     {
         MOON_CORE_ASSERT(!exists(name), "Shader already exists!");
-        shaders_[name.data()] = shader;
+        shaders_[std::string(name)] = shader;
     }
 
     void shader_library::add(const ref<shader>& shader)
@@ -62,14 +109,23 @@ namespace moon
         return shader;
     }
 
+    void shader_library::load_all(std::initializer_list<std::string_view> file_paths)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        // creating a shader only issues its compile, nothing here waits on the driver
+        for (std::string_view file_path : file_paths)
+            load(file_path);
+    }
+
     ref<shader> shader_library::get(std::string_view name)
     {
         MOON_CORE_ASSERT(exists(name), "Shader does not exist!");
-        return shaders_[name.data()];
+        return shaders_[std::string(name)];
     }
 
     bool shader_library::exists(std::string_view name)
     {
-        return shaders_.contains(name.data());
+        return shaders_.contains(std::string(name));
     }
 }
@@ -2,8 +2,11 @@
 
 #include "moon/core/core.h"
 
+#include <initializer_list>
+#include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 #include <glm/glm.hpp>
 
 namespace moon
@@ -17,6 +20,11 @@ namespace moon
         virtual void unbind() const = 0;
 
         virtual std::string_view get_name() = 0;
+        /// Recompiles the file the shader was created from. A failed compile keeps the current program and
+        /// returns false, as do shaders created from source strings
+        virtual bool reload() = 0;
+        /// Files pulled in through #include, empty for shaders built from source strings
+        [[nodiscard]] virtual const std::vector<std::string>& get_include_paths() const = 0;
 
         virtual void set_int(std::string_view name, int value) = 0;
         virtual void set_int_array(std::string_view name, int* values, uint32_t count) = 0;
@@ -27,9 +35,28 @@ namespace moon
         virtual void set_mat4(std::string_view name, const glm::mat4& value) = 0;
 
         static ref<shader> create(std::string_view file_path);
+        /// Compiles the permutation of file_path with each of defines set
+        static ref<shader> create(std::string_view file_path, std::vector<std::string> defines);
         static ref<shader> create(std::string_view name, std::string_view vertex_src, std::string_view fragment_src);
     };
 
+    /// The define permutations of one shader file. Each is compiled the first time it is asked for and shared
+    /// from then on; defines may be given in any order
+    class MOON_API shader_variants
+    {
+    public:
+        shader_variants() = default;
+        explicit shader_variants(std::string_view file_path) : file_path_(file_path) {}
+
+        ref<shader> get(std::initializer_list<std::string_view> defines = {});
+
+        [[nodiscard]] size_t size() const { return variants_.size(); }
+
+    private:
+        std::string file_path_;
+        std::unordered_map<std::string, ref<shader>> variants_;
+    };
+
     class MOON_API shader_library
     {
     public:
@@ -40,6 +67,9 @@ namespace moon
         void add(const ref<shader>& shader);
         ref<shader> load(std::string_view file_path);
         ref<shader> load(std::string_view name, std::string_view filepath);
+        /// Starts every compile before any of them is waited on, so loading many shaders costs about as much
+        /// as the slowest one. Each shader finishes on first use
+        void load_all(std::initializer_list<std::string_view> file_paths);
 
         ref<shader> get(std::string_view name);
 
@@ -0,0 +1,168 @@
+#include "moonpch.h"
+#include "shader_preprocessor.h"
+
+#include <filesystem>
+
+namespace moon
+{
+    static constexpr uint32_t s_max_include_depth = 16;
+
+    static std::string_view trim(std::string_view s)
+    {
+        const size_t begin = s.find_first_not_of(" \t\r");
+        if (begin == std::string_view::npos)
+            return {};
+        const size_t end = s.find_last_not_of(" \t\r");
+        return s.substr(begin, end - begin + 1);
+    }
+
+    /// Calls fn(line, line_with_newline) for every line of source
+    template<typename Fn>
+    static void for_each_line(std::string_view source, Fn&& fn)
+    {
+        size_t pos = 0;
+        while (pos < source.size())
+        {
+            size_t eol = source.find('\n', pos);
+            const size_t next = eol == std::string_view::npos ? source.size() : eol + 1;
+            fn(source.substr(pos, (eol == std::string_view::npos ? source.size() : eol) - pos), source.substr(pos, next - pos));
+            pos = next;
+        }
+    }
+
+    static bool resolve_includes_recursive(std::string_view source, const std::filesystem::path& path,
+                                           const shader_preprocessor::file_reader& read, std::string& out,
+                                           std::vector<std::string>& included, std::vector<std::string>& all_included,
+                                           uint32_t depth)
+    {
+        if (depth > s_max_include_depth)
+        {
+            MOON_CORE_ERROR("Shader includes nest deeper than {0} levels at '{1}', is there a cycle?", s_max_include_depth, path.generic_string());
+            return false;
+        }
+
+        bool ok = true;
+        for_each_line(source, [&](std::string_view line, std::string_view line_with_newline)
+        {
+            const std::string_view directive = trim(line);
+            if (!ok || !directive.starts_with("#include"))
+            {
+                out.append(line_with_newline);
+                return;
+            }
+
+            const size_t open = directive.find('"');
+            const size_t close = open == std::string_view::npos ? open : directive.find('"', open + 1);
+            if (close == std::string_view::npos)
+            {
+                MOON_CORE_ERROR("Malformed include in '{0}': {1}", path.generic_string(), directive);
+                ok = false;
+                return;
+            }
+
+            const std::string include_path = (path.parent_path() / directive.substr(open + 1, close - open - 1))
+                .lexically_normal().generic_string();
+            if (std::ranges::find(included, include_path) != included.end())
+                return;
+            included.push_back(include_path);
+            if (std::ranges::find(all_included, include_path) == all_included.end())
+                all_included.push_back(include_path);
+
+            const std::string include_source = read(include_path);
+            if (include_source.empty())
+            {
+                MOON_CORE_ERROR("Failed to include '{0}' from '{1}'", include_path, path.generic_string());
+                ok = false;
+                return;
+            }
+
+            ok = resolve_includes_recursive(include_source, include_path, read, out, included, all_included, depth + 1);
+            if (!out.empty() && out.back() != '\n')
+                out.push_back('\n');
+        });
+
+        return ok;
+    }
+
+    bool shader_preprocessor::resolve_includes(std::string_view source, std::string_view path, const file_reader& read,
+                                               std::string& out, std::vector<std::string>& out_included)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        out.clear();
+        out.reserve(source.size());
+        std::vector<std::string> included;
+        return resolve_includes_recursive(source, std::filesystem::path(path), read, out, included, out_included, 0);
+    }
+
+    std::vector<shader_stage_source> shader_preprocessor::split_stages(std::string_view source)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        constexpr std::string_view type_token = "#type";
+
+        std::vector<shader_stage_source> stages;
+        size_t pos = source.find(type_token);
+        while (pos != std::string_view::npos)
+        {
+            const size_t eol = source.find('\n', pos);
+            if (eol == std::string_view::npos)
+            {
+                MOON_CORE_ERROR("Shader stage '{0}' has no code", trim(source.substr(pos + type_token.size())));
+                break;
+            }
+
+            const std::string_view type = trim(source.substr(pos + type_token.size(), eol - pos - type_token.size()));
+            const size_t code_begin = eol + 1;
+            pos = source.find(type_token, code_begin);
+
+            const size_t code_end = pos == std::string_view::npos ? source.size() : pos;
+            stages.push_back({ type, source.substr(code_begin, code_end - code_begin) });
+        }
+
+        return stages;
+    }
+
+    std::string shader_preprocessor::add_defines(std::string_view stage_code, const std::vector<std::string>& defines)
+    {
+        if (defines.empty())
+            return std::string(stage_code);
+
+        size_t insert_at = 0;
+        const size_t version = stage_code.find("#version");
+        if (version != std::string_view::npos)
+        {
+            const size_t eol = stage_code.find('\n', version);
+            insert_at = eol == std::string_view::npos ? stage_code.size() : eol + 1;
+        }
+
+        std::string result;
+        result.reserve(stage_code.size() + defines.size() * 32);
+        result.append(stage_code.substr(0, insert_at));
+        if (!result.empty() && result.back() != '\n')
+            result.push_back('\n');
+        for (const auto& define : defines)
+        {
+            result.append("#define ");
+            result.append(define);
+            result.push_back('\n');
+        }
+        result.append(stage_code.substr(insert_at));
+        return result;
+    }
+
+    std::string shader_preprocessor::make_permutation_key(std::vector<std::string>& defines)
+    {
+        std::ranges::sort(defines);
+        defines.erase(std::unique(defines.begin(), defines.end()), defines.end());
+
+        std::string key;
+        for (const auto& define : defines)
+        {
+            if (!key.empty())
+                key.push_back('+');
+            key.append(define);
+        }
+        return key;
+    }
+}
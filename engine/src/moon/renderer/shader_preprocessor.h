@@ -0,0 +1,41 @@
+#pragma once
+
+#include "moon/core/core.h"
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace moon
+{
+    /// One #type section of a shader file, views into the preprocessed source
+    struct shader_stage_source
+    {
+        std::string_view type;
+        std::string_view code;
+    };
+
+    /// Backend independent GLSL source handling: include resolution, stage splitting and define permutations
+    class MOON_API shader_preprocessor
+    {
+    public:
+        /// Returns the file's contents, empty if it can't be read
+        using file_reader = std::function<std::string(std::string_view path)>;
+
+        /// Replaces every #include "file" line with the file's contents, recursively. Paths are relative to the
+        /// including file and every file is spliced in once per call, so shared headers need no guards.
+        /// Paths of included files not yet in out_included are appended to it
+        static bool resolve_includes(std::string_view source, std::string_view path, const file_reader& read,
+                                     std::string& out, std::vector<std::string>& out_included);
+
+        /// Splits on "#type <stage>" lines without copying
+        static std::vector<shader_stage_source> split_stages(std::string_view source);
+
+        /// Inserts a #define line per entry after the #version line, which has to stay first
+        static std::string add_defines(std::string_view stage_code, const std::vector<std::string>& defines);
+
+        /// Sorts and deduplicates defines, returns them joined with '+', the same key for every order
+        static std::string make_permutation_key(std::vector<std::string>& defines);
+    };
+}
@@ -2,11 +2,16 @@
 #include "texture.h"
 
 #include "renderer.h"
+#include "renderer2d.h"
+#include "texture_loader.h"
+#include "texture_cache.h"
+#include "moon/asset/asset_archive.h"
+#include "moon/asset/asset_watcher.h"
 #include "platform/opengl/opengl_texture.h"
 
 namespace moon
 {
-    ref<texture2d> texture2d::create(uint32_t width, uint32_t height)
+    ref<texture2d> texture2d::create(uint32_t width, uint32_t height, const texture_spec& spec)
     {
         switch (renderer::get_api())
         {
@@ -14,14 +19,19 @@ namespace moon
             MOON_CORE_ASSERT(false, "RendererAPI::None is not supported");
             return nullptr;
         case renderer_api::API::OpenGL:
-            return create_ref<opengl_texture2d>(width, height);
+            return create_ref<opengl_texture2d>(width, height, spec);
         }
 
         MOON_CORE_ASSERT(false, "Unknown RendererAPI!");
         return nullptr;
     }
 
-    ref<texture2d> texture2d::create(std::string_view path)
+    ref<texture2d> texture2d::create(std::string_view path, const texture_spec& spec)
+    {
+        return texture_cache::get(path, spec);
+    }
+
+    ref<texture2d> texture2d::create_uncached(std::string_view path, const texture_spec& spec)
     {
         switch (renderer::get_api())
         {
@@ -29,7 +39,51 @@ namespace moon
                 MOON_CORE_ASSERT(false, "RendererAPI::None is not supported");
                 return nullptr;
             case renderer_api::API::OpenGL:
-                return create_ref<opengl_texture2d>(path);
+            {
+                ref<texture2d> texture = create_ref<opengl_texture2d>(path, spec);
+                asset_watcher::watch(texture, path);
+                return texture;
+            }
+        }
+
+        MOON_CORE_ASSERT(false, "Unknown RendererAPI!");
+        return nullptr;
+    }
+
+    ref<texture2d> texture2d::create_async(std::string_view path, const texture_spec& spec)
+    {
+        // block compressed and cooked data is ready for upload as is, there's nothing to decode on a worker
+        packed_asset asset;
+        if (path.ends_with(".dds") || asset_archive::find(path, asset))
+            return create_uncached(path, spec);
+
+        switch (renderer::get_api())
+        {
+        case renderer_api::API::None:
+            MOON_CORE_ASSERT(false, "RendererAPI::None is not supported");
+            return nullptr;
+        case renderer_api::API::OpenGL:
+        {
+            ref<texture2d> texture = create_ref<opengl_texture2d>(path, renderer2d::get_white_texture(), spec);
+            texture_loader::load(texture, path);
+            asset_watcher::watch(texture, path);
+            return texture;
+        }
+        }
+
+        MOON_CORE_ASSERT(false, "Unknown RendererAPI!");
+        return nullptr;
+    }
+
+    ref<texture2d_array> texture2d_array::create(uint32_t width, uint32_t height, uint32_t layer_count)
+    {
+        switch (renderer::get_api())
+        {
+        case renderer_api::API::None:
+            MOON_CORE_ASSERT(false, "RendererAPI::None is not supported");
+            return nullptr;
+        case renderer_api::API::OpenGL:
+            return create_ref<opengl_texture2d_array>(width, height, layer_count);
         }
 
         MOON_CORE_ASSERT(false, "Unknown RendererAPI!");
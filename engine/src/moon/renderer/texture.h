@@ -7,6 +7,44 @@
 
 namespace moon
 {
+    enum class texture_format
+    {
+        RGB8,
+        RGBA8,
+        /// Single channel, sampled as white with the channel in alpha (masks, distance fields)
+        R8,
+        // block compressed, loaded from .dds files produced offline
+        BC1,
+        BC3,
+        BC7
+    };
+
+    enum class texture_filter
+    {
+        nearest,
+        linear
+    };
+
+    enum class texture_wrap
+    {
+        repeat,
+        clamp_to_edge,
+        mirrored_repeat
+    };
+
+    struct texture_spec
+    {
+        /// Only honored by textures created with a size. Images loaded from disk decide their own format:
+        /// 3 and 4 channel images become RGB8 and RGBA8, .dds files keep their block format. get_spec
+        /// reports the format that was actually loaded
+        texture_format format = texture_format::RGBA8;
+        /// Builds a full mip chain for uncompressed images, compressed files use the levels they contain
+        bool generate_mips = false;
+        texture_filter min_filter = texture_filter::linear;
+        texture_filter mag_filter = texture_filter::nearest;
+        texture_wrap wrap = texture_wrap::repeat;
+    };
+
     class MOON_API texture
     {
     public:
@@ -15,6 +53,8 @@ namespace moon
         [[nodiscard]] virtual uint32_t get_width() const = 0;
         [[nodiscard]] virtual uint32_t get_height() const = 0;
         [[nodiscard]] virtual uint32_t get_renderer_id() const = 0;
+        /// Bytes of video memory the texture occupies
+        [[nodiscard]] virtual uint64_t get_memory_size() const = 0;
 
         virtual void set_data(void* data, uint32_t size) = 0;
 
@@ -28,7 +68,41 @@ namespace moon
     public:
         virtual ~texture2d() override = default;
 
-        static ref<texture2d> create(uint32_t width, uint32_t height);
-        static ref<texture2d> create(std::string_view path);
+        /// Overwrites a width x height block at (x, y), data is in the texture's format
+        virtual void set_region_data(const void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
+        /// Replaces the storage with a new image, channels is 3 or 4 and decides the format regardless of the spec
+        virtual void upload_image(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels) = 0;
+        /// False while an asynchronously created texture still shows its placeholder
+        [[nodiscard]] virtual bool is_loaded() const = 0;
+        /// Reads the file the texture was created from again, synchronously. Keeps the current image and
+        /// returns false if that fails or the texture wasn't created from a file
+        virtual bool reload() = 0;
+        [[nodiscard]] virtual const texture_spec& get_spec() const = 0;
+
+        static ref<texture2d> create(uint32_t width, uint32_t height, const texture_spec& spec = {});
+        /// Goes through texture_cache, so every caller asking for the same image shares one texture
+        static ref<texture2d> create(std::string_view path, const texture_spec& spec = {});
+        /// Always loads a new texture, for textures that get modified after loading
+        static ref<texture2d> create_uncached(std::string_view path, const texture_spec& spec = {});
+        /// Returns immediately with the renderer2d white texture as a placeholder; the image is decoded on a
+        /// worker thread and uploaded by texture_loader::process_uploads. .dds files load synchronously
+        static ref<texture2d> create_async(std::string_view path, const texture_spec& spec = {});
+    };
+
+    /// Same-sized rgba images stored as the layers of one texture. Shaders select the image by layer,
+    /// so any number of sprites share a single binding
+    class MOON_API texture2d_array : public texture
+    {
+    public:
+        virtual ~texture2d_array() override = default;
+
+        [[nodiscard]] virtual uint32_t get_layer_count() const = 0;
+
+        /// data is one whole layer
+        virtual void set_layer_data(uint32_t layer, const void* data, uint32_t size) = 0;
+        /// The image must have the array's size
+        virtual bool load_layer(uint32_t layer, std::string_view path) = 0;
+
+        static ref<texture2d_array> create(uint32_t width, uint32_t height, uint32_t layer_count);
     };
 }
@@ -0,0 +1,187 @@
+#include "moonpch.h"
+#include "texture_atlas.h"
+
+#include <stb_image.h>
+
+#include <limits>
+
+namespace moon
+{
+    texture_atlas::texture_atlas(uint32_t page_size, uint32_t padding)
+        :
+        m_page_size_(page_size),
+        m_padding_(padding)
+    {
+        MOON_CORE_ASSERT(page_size > 2 * padding, "Atlas pages must be larger than their padding!");
+    }
+
+    ref<subtexture2d> texture_atlas::add(std::string_view path)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        const std::string path_string(path);
+
+        stbi_set_flip_vertically_on_load(true);
+        int width, height, channels;
+        stbi_uc* pixels = stbi_load(path_string.c_str(), &width, &height, &channels, 4);
+        if (!pixels)
+        {
+            MOON_CORE_ERROR("Failed to load image '{0}' into atlas: {1}", path, stbi_failure_reason());
+            return nullptr;
+        }
+
+        ref<subtexture2d> region = add(pixels, (uint32_t)width, (uint32_t)height);
+        stbi_image_free(pixels);
+        return region;
+    }
+
+    ref<subtexture2d> texture_atlas::add(const uint8_t* rgba_pixels, uint32_t width, uint32_t height)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        const uint32_t padded_width = width + m_padding_;
+        const uint32_t padded_height = height + m_padding_;
+        if (padded_width + m_padding_ > m_page_size_ || padded_height + m_padding_ > m_page_size_)
+        {
+            MOON_CORE_WARN("Image of {0}x{1} doesn't fit into {2}x{2} atlas pages", width, height, m_page_size_);
+            return nullptr;
+        }
+
+        // first fit over the pages, so older pages keep filling their holes
+        size_t page_index = 0;
+        uint32_t x = 0, y = 0;
+        size_t node = 0;
+        for (; page_index < m_pages_.size(); page_index++)
+        {
+            if (find_position(m_pages_[page_index], padded_width, padded_height, x, y, node))
+                break;
+        }
+
+        if (page_index == m_pages_.size())
+        {
+            add_page();
+            const bool found = find_position(m_pages_.back(), padded_width, padded_height, x, y, node);
+            MOON_CORE_ASSERT(found, "Fresh atlas page has no room!");
+        }
+
+        page& p = m_pages_[page_index];
+        place(p, node, x, y, padded_width, padded_height);
+        p.used_pixels += (uint64_t)width * height;
+        p.image_count++;
+
+        const ref<texture2d>& texture = m_page_textures_[page_index];
+        texture->set_region_data(rgba_pixels, x, y, width, height);
+
+        const float size = (float)m_page_size_;
+        return create_ref<subtexture2d>(texture, glm::vec2 { (float)x / size, (float)y / size },
+            glm::vec2 { (float)(x + width) / size, (float)(y + height) / size });
+    }
+
+    texture_atlas_stats texture_atlas::get_stats() const
+    {
+        texture_atlas_stats stats;
+        stats.page_count = (uint32_t)m_pages_.size();
+        stats.page_pixels = (uint64_t)m_page_size_ * m_page_size_ * m_pages_.size();
+        for (const page& p : m_pages_)
+        {
+            stats.image_count += p.image_count;
+            stats.used_pixels += p.used_pixels;
+        }
+        return stats;
+    }
+
+    bool texture_atlas::find_position(const page& p, uint32_t width, uint32_t height, uint32_t& out_x, uint32_t& out_y, size_t& out_node) const
+    {
+        uint32_t best_top = std::numeric_limits<uint32_t>::max();
+        uint32_t best_node_width = std::numeric_limits<uint32_t>::max();
+        bool found = false;
+
+        for (size_t i = 0; i < p.skyline.size(); i++)
+        {
+            const uint32_t x = p.skyline[i].x;
+            if (x + width > m_page_size_)
+                break;
+
+            // the rect rests on the highest segment it spans
+            uint32_t y = 0;
+            uint32_t remaining = width;
+            for (size_t j = i; remaining > 0; j++)
+            {
+                y = std::max(y, p.skyline[j].y);
+                remaining -= std::min(remaining, p.skyline[j].width);
+            }
+
+            if (y + height > m_page_size_)
+                continue;
+
+            // lowest top edge wins, ties go to the narrower segment to leave wide ones for wide images
+            if (y + height < best_top || (y + height == best_top && p.skyline[i].width < best_node_width))
+            {
+                best_top = y + height;
+                best_node_width = p.skyline[i].width;
+                out_x = x;
+                out_y = y;
+                out_node = i;
+                found = true;
+            }
+        }
+
+        return found;
+    }
+
+    void texture_atlas::place(page& p, size_t node, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+    {
+        p.skyline.insert(p.skyline.begin() + (ptrdiff_t)node, { x, y + height, width });
+
+        // trim or drop the segments the new one covers
+        for (size_t i = node + 1; i < p.skyline.size();)
+        {
+            skyline_node& previous = p.skyline[i - 1];
+            skyline_node& current = p.skyline[i];
+            const uint32_t previous_end = previous.x + previous.width;
+            if (current.x >= previous_end)
+                break;
+
+            const uint32_t overlap = previous_end - current.x;
+            if (overlap >= current.width)
+            {
+                p.skyline.erase(p.skyline.begin() + (ptrdiff_t)i);
+                continue;
+            }
+
+            current.x += overlap;
+            current.width -= overlap;
+            break;
+        }
+
+        // merge neighbours of equal height
+        for (size_t i = 0; i + 1 < p.skyline.size();)
+        {
+            if (p.skyline[i].y == p.skyline[i + 1].y)
+            {
+                p.skyline[i].width += p.skyline[i + 1].width;
+                p.skyline.erase(p.skyline.begin() + (ptrdiff_t)(i + 1));
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
+
+    void texture_atlas::add_page()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        ref<texture2d> texture = texture2d::create(m_page_size_, m_page_size_);
+        // storage starts out undefined, padding has to be transparent
+        std::vector<uint32_t> clear((size_t)m_page_size_ * m_page_size_, 0);
+        texture->set_data(clear.data(), (uint32_t)(clear.size() * sizeof(uint32_t)));
+
+        page p;
+        // the padding margin runs along the left and bottom edges, every image pads its right and top
+        p.skyline.push_back({ m_padding_, m_padding_, m_page_size_ - m_padding_ });
+        m_pages_.push_back(std::move(p));
+        m_page_textures_.push_back(std::move(texture));
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "moon/core/core.h"
+#include "moon/renderer/texture.h"
+#include "moon/renderer/subtexture2d.h"
+
+#include <string_view>
+#include <vector>
+
+namespace moon
+{
+    struct texture_atlas_stats
+    {
+        uint32_t page_count = 0;
+        uint32_t image_count = 0;
+        uint64_t used_pixels = 0;
+        uint64_t page_pixels = 0;
+
+        /// Share of the pages' area covered by images
+        [[nodiscard]] float get_efficiency() const { return page_pixels ? (float)used_pixels / (float)page_pixels : 0.0f; }
+    };
+
+    /// Packs images into a few large rgba pages with a bottom-left skyline packer, so sprites drawn from
+    /// it share texture slots and batch together. Pages are added as the previous ones fill up
+    class MOON_API texture_atlas
+    {
+    public:
+        /// padding keeps transparent texels between images so filtering doesn't bleed neighbours in
+        explicit texture_atlas(uint32_t page_size = 2048, uint32_t padding = 1);
+
+        /// nullptr when the image can't be loaded or is larger than a page
+        ref<subtexture2d> add(std::string_view path);
+        ref<subtexture2d> add(const uint8_t* rgba_pixels, uint32_t width, uint32_t height);
+
+        [[nodiscard]] const std::vector<ref<texture2d>>& get_pages() const { return m_page_textures_; }
+        [[nodiscard]] texture_atlas_stats get_stats() const;
+
+    private:
+        struct skyline_node
+        {
+            uint32_t x, y, width;
+        };
+
+        struct page
+        {
+            std::vector<skyline_node> skyline;
+            uint64_t used_pixels = 0;
+            uint32_t image_count = 0;
+        };
+
+        /// Lowest position for a width x height rect, false if the page has no room
+        bool find_position(const page& p, uint32_t width, uint32_t height, uint32_t& out_x, uint32_t& out_y, size_t& out_node) const;
+        void place(page& p, size_t node, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+        void add_page();
+
+    private:
+        uint32_t m_page_size_;
+        uint32_t m_padding_;
+
+        std::vector<page> m_pages_;
+        std::vector<ref<texture2d>> m_page_textures_;
+    };
+}
@@ -0,0 +1,241 @@
+#include "moonpch.h"
+#include "texture_cache.h"
+
+#include "moon/core/mapped_file.h"
+#include "moon/asset/asset_archive.h"
+#include "moon/asset/asset_watcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <unordered_map>
+
+namespace moon
+{
+    struct texture_cache_entry
+    {
+        ref<texture2d> texture;
+        std::string source_path; // as the first caller passed it, aliases are compared against this file
+        std::vector<std::string> paths; // every normalized path that resolved to this content
+        uint64_t content_hash = 0;
+        uint64_t last_used = 0;
+    };
+
+    /// The bytes of a texture file, from a mounted archive or a mapping of the loose file
+    struct texture_source
+    {
+        packed_asset asset;
+        mapped_file file;
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+
+        bool open(std::string_view path)
+        {
+            if (asset_archive::find(path, asset))
+            {
+                data = asset.data;
+                size = (size_t)asset.size;
+                return true;
+            }
+            if (!file.open(path))
+                return false;
+
+            data = file.data();
+            size = file.size();
+            return true;
+        }
+    };
+
+    struct texture_cache_data
+    {
+        // entries are keyed by normalized path and spec; the content hash only finds candidates for aliasing
+        std::unordered_map<std::string, uint64_t> path_to_entry;
+        std::unordered_multimap<uint64_t, uint64_t> hash_to_entries;
+        std::unordered_map<uint64_t, texture_cache_entry> entries;
+
+        uint64_t next_entry_id = 0;
+        uint64_t use_counter = 0;
+        texture_cache_stats stats;
+
+        texture_cache_data()
+        {
+            stats.memory_budget = 512ull * 1024 * 1024;
+        }
+    };
+
+    static texture_cache_data s_cache;
+
+    static uint64_t fnv1a(const uint8_t* data, size_t size)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= data[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    static std::string normalize_path(std::string_view path)
+    {
+        std::error_code ec;
+        std::filesystem::path absolute = std::filesystem::absolute(std::filesystem::path(path), ec);
+        if (ec)
+            absolute = std::filesystem::path(path);
+        return absolute.lexically_normal().generic_string();
+    }
+
+    static uint64_t spec_key(const texture_spec& spec)
+    {
+        return (uint64_t)spec.format | (uint64_t)spec.generate_mips << 8 | (uint64_t)spec.min_filter << 9
+            | (uint64_t)spec.mag_filter << 10 | (uint64_t)spec.wrap << 11;
+    }
+
+    ref<texture2d> texture_cache::get(std::string_view path, const texture_spec& spec)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        const uint64_t key = spec_key(spec);
+        std::string normalized = normalize_path(path) + '#' + std::to_string(key);
+
+        if (auto it = s_cache.path_to_entry.find(normalized); it != s_cache.path_to_entry.end())
+        {
+            texture_cache_entry& entry = s_cache.entries.at(it->second);
+            entry.last_used = ++s_cache.use_counter;
+            s_cache.stats.hits++;
+            return entry.texture;
+        }
+
+        texture_source source;
+        if (!source.open(path))
+        {
+            MOON_CORE_ERROR("Could not open texture '{0}'", path);
+            return texture2d::create_uncached(path, spec);
+        }
+
+        uint64_t hash;
+        {
+            MOON_PROFILE_SCOPE("texture_cache hash contents");
+
+            hash = fnv1a(source.data, source.size) ^ key * 1099511628211ull;
+        }
+
+        // same image under another name; a matching hash is only a hint, the bytes have to match too
+        const auto [first, last] = s_cache.hash_to_entries.equal_range(hash);
+        for (auto it = first; it != last; ++it)
+        {
+            texture_cache_entry& entry = s_cache.entries.at(it->second);
+
+            texture_source other;
+            if (!other.open(entry.source_path) || other.size != source.size || std::memcmp(other.data, source.data, source.size) != 0)
+                continue;
+
+            entry.paths.push_back(normalized);
+            entry.last_used = ++s_cache.use_counter;
+            s_cache.path_to_entry.emplace(std::move(normalized), it->second);
+            s_cache.stats.hits++;
+
+            // an edit to any of the identical files reloads the shared texture
+            asset_watcher::watch(entry.texture, path);
+            return entry.texture;
+        }
+
+        ref<texture2d> texture = texture2d::create_uncached(path, spec);
+
+        const uint64_t id = s_cache.next_entry_id++;
+        texture_cache_entry& entry = s_cache.entries[id];
+        entry.texture = texture;
+        entry.source_path = path;
+        entry.paths.push_back(normalized);
+        entry.content_hash = hash;
+        entry.last_used = ++s_cache.use_counter;
+        s_cache.path_to_entry.emplace(std::move(normalized), id);
+        s_cache.hash_to_entries.emplace(hash, id);
+
+        s_cache.stats.misses++;
+        s_cache.stats.texture_count++;
+
+        trim();
+        return texture;
+    }
+
+    void texture_cache::set_memory_budget(uint64_t bytes)
+    {
+        s_cache.stats.memory_budget = bytes;
+        trim();
+    }
+
+    /// Asked of the textures every time, hot reloads can change their size and format
+    static uint64_t get_memory_usage()
+    {
+        uint64_t usage = 0;
+        for (const auto& [id, entry] : s_cache.entries)
+            usage += entry.texture->get_memory_size();
+        return usage;
+    }
+
+    void texture_cache::trim()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        s_cache.stats.memory_usage = get_memory_usage();
+        if (s_cache.stats.memory_usage <= s_cache.stats.memory_budget)
+            return;
+
+        // only the cache holds these
+        std::vector<std::pair<uint64_t, uint64_t>> unused; // last_used, entry id
+        for (const auto& [id, entry] : s_cache.entries)
+        {
+            if (entry.texture.use_count() == 1)
+                unused.emplace_back(entry.last_used, id);
+        }
+        std::ranges::sort(unused);
+
+        for (const auto& [last_used, id] : unused)
+        {
+            if (s_cache.stats.memory_usage <= s_cache.stats.memory_budget)
+                break;
+
+            auto it = s_cache.entries.find(id);
+            for (const auto& p : it->second.paths)
+                s_cache.path_to_entry.erase(p);
+
+            const auto [first, last] = s_cache.hash_to_entries.equal_range(it->second.content_hash);
+            for (auto hint = first; hint != last; ++hint)
+            {
+                if (hint->second == id)
+                {
+                    s_cache.hash_to_entries.erase(hint);
+                    break;
+                }
+            }
+
+            s_cache.stats.memory_usage -= it->second.texture->get_memory_size();
+            s_cache.stats.texture_count--;
+            s_cache.stats.evictions++;
+            s_cache.entries.erase(it);
+        }
+
+        if (s_cache.stats.memory_usage > s_cache.stats.memory_budget)
+            MOON_CORE_WARN("Texture cache is over budget ({0} MB of {1} MB) with every texture in use",
+                s_cache.stats.memory_usage / (1024 * 1024), s_cache.stats.memory_budget / (1024 * 1024));
+    }
+
+    void texture_cache::clear()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        s_cache.path_to_entry.clear();
+        s_cache.hash_to_entries.clear();
+        s_cache.entries.clear();
+        s_cache.stats.texture_count = 0;
+        s_cache.stats.memory_usage = 0;
+    }
+
+    texture_cache_stats texture_cache::get_stats()
+    {
+        texture_cache_stats stats = s_cache.stats;
+        stats.memory_usage = get_memory_usage();
+        return stats;
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "moon/core/core.h"
+#include "moon/renderer/texture.h"
+
+#include <string_view>
+
+namespace moon
+{
+    struct texture_cache_stats
+    {
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+        uint32_t evictions = 0;
+
+        uint32_t texture_count = 0;
+        uint64_t memory_usage = 0;
+        uint64_t memory_budget = 0;
+    };
+
+    /// Shares textures loaded from disk. Lookups go by normalized path; a file that isn't cached yet is hashed,
+    /// and if a cached file has the same hash and the same bytes, both names share one texture. Every name
+    /// is watched for hot reloading, so an edit to any of the copies reloads the shared texture.
+    /// Textures only the cache still references are evicted least recently used first once the memory
+    /// budget is exceeded. Main thread only
+    class MOON_API texture_cache
+    {
+    public:
+        /// Textures of the same file with different specs are cached separately
+        static ref<texture2d> get(std::string_view path, const texture_spec& spec = {});
+
+        static void set_memory_budget(uint64_t bytes);
+        /// Evicts unused textures until the cache fits its budget, runs after every miss
+        static void trim();
+        /// Drops every cached texture, textures still in use elsewhere stay alive with their owners
+        static void clear();
+
+        static texture_cache_stats get_stats();
+    };
+}
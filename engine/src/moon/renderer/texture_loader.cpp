@@ -0,0 +1,217 @@
+#include "moonpch.h"
+#include "texture_loader.h"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace moon
+{
+    using load_clock = std::chrono::steady_clock;
+
+    struct stbi_deleter
+    {
+        void operator()(stbi_uc* pixels) const { stbi_image_free(pixels); }
+    };
+
+    struct texture_load_request
+    {
+        std::weak_ptr<texture2d> texture;
+        std::string path;
+        load_clock::time_point requested_at;
+    };
+
+    struct decoded_image
+    {
+        texture_load_request request;
+        std::unique_ptr<stbi_uc, stbi_deleter> pixels;
+        uint32_t width = 0, height = 0, channels = 0;
+        const char* failure_reason = nullptr; // stb keeps it per thread
+    };
+
+    struct texture_loader_data
+    {
+        static constexpr uint32_t max_workers = 4;
+
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool stop = false;
+
+        std::deque<texture_load_request> requests;
+        std::deque<decoded_image> decoded;
+
+        uint64_t upload_budget = 16ull * 1024 * 1024;
+
+        texture_load_stats stats;
+        double latency_sum_ms = 0.0;
+    };
+
+    static texture_loader_data* s_loader = nullptr;
+
+    static void worker_main()
+    {
+        // the global flag isn't safe to use from several threads
+        stbi_set_flip_vertically_on_load_thread(1);
+
+        while (true)
+        {
+            texture_load_request request;
+            {
+                std::unique_lock lock(s_loader->mutex);
+                s_loader->cv.wait(lock, []() { return s_loader->stop || !s_loader->requests.empty(); });
+                if (s_loader->stop)
+                    return;
+
+                request = std::move(s_loader->requests.front());
+                s_loader->requests.pop_front();
+            }
+
+            // nobody is waiting for it anymore
+            if (request.texture.expired())
+            {
+                std::lock_guard lock(s_loader->mutex);
+                s_loader->stats.pending--;
+                continue;
+            }
+
+            decoded_image image;
+            {
+                MOON_PROFILE_SCOPE("stbi_load - texture_loader worker");
+
+                int width, height, channels;
+                int desired_channels = 0;
+                if (stbi_info(request.path.c_str(), &width, &height, &channels) && channels != 3)
+                    desired_channels = 4;
+
+                image.pixels.reset(stbi_load(request.path.c_str(), &width, &height, &channels, desired_channels));
+                image.width = (uint32_t)width;
+                image.height = (uint32_t)height;
+                image.channels = desired_channels ? (uint32_t)desired_channels : (uint32_t)channels;
+                if (!image.pixels)
+                    image.failure_reason = stbi_failure_reason();
+            }
+            image.request = std::move(request);
+
+            std::lock_guard lock(s_loader->mutex);
+            s_loader->decoded.push_back(std::move(image));
+        }
+    }
+
+    void texture_loader::init()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        s_loader = new texture_loader_data;
+
+        const uint32_t hardware_threads = std::max(2u, std::thread::hardware_concurrency());
+        const uint32_t worker_count = std::min(texture_loader_data::max_workers, hardware_threads - 1);
+        for (uint32_t i = 0; i < worker_count; i++)
+            s_loader->workers.emplace_back(worker_main);
+    }
+
+    void texture_loader::shutdown()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        {
+            std::lock_guard lock(s_loader->mutex);
+            s_loader->stop = true;
+        }
+        s_loader->cv.notify_all();
+
+        for (auto& worker : s_loader->workers)
+            worker.join();
+
+        delete s_loader;
+        s_loader = nullptr;
+    }
+
+    void texture_loader::load(const ref<texture2d>& texture, std::string_view path)
+    {
+        MOON_CORE_ASSERT(s_loader, "texture_loader isn't initialized!");
+
+        {
+            std::lock_guard lock(s_loader->mutex);
+            s_loader->requests.push_back({ texture, std::string(path), load_clock::now() });
+            s_loader->stats.requested++;
+            s_loader->stats.pending++;
+        }
+        s_loader->cv.notify_one();
+    }
+
+    void texture_loader::process_uploads()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        uint64_t uploaded_bytes = 0;
+        while (true)
+        {
+            decoded_image image;
+            {
+                std::lock_guard lock(s_loader->mutex);
+                if (s_loader->decoded.empty())
+                    break;
+
+                const decoded_image& next = s_loader->decoded.front();
+                const uint64_t size = (uint64_t)next.width * next.height * next.channels;
+                if (uploaded_bytes > 0 && uploaded_bytes + size > s_loader->upload_budget)
+                    break;
+
+                image = std::move(s_loader->decoded.front());
+                s_loader->decoded.pop_front();
+                s_loader->stats.pending--;
+            }
+
+            ref<texture2d> texture = image.request.texture.lock();
+            if (!texture)
+                continue;
+
+            if (!image.pixels)
+            {
+                MOON_CORE_ERROR("Failed to load image '{0}': {1}", image.request.path, image.failure_reason ? image.failure_reason : "unknown error");
+                std::lock_guard lock(s_loader->mutex);
+                s_loader->stats.failed++;
+                continue;
+            }
+
+            texture->upload_image(image.pixels.get(), image.width, image.height, image.channels);
+            uploaded_bytes += (uint64_t)image.width * image.height * image.channels;
+
+            const float latency_ms = std::chrono::duration<float, std::milli>(load_clock::now() - image.request.requested_at).count();
+            std::lock_guard lock(s_loader->mutex);
+            texture_load_stats& stats = s_loader->stats;
+            stats.completed++;
+            stats.last_latency_ms = latency_ms;
+            stats.max_latency_ms = std::max(stats.max_latency_ms, latency_ms);
+            s_loader->latency_sum_ms += latency_ms;
+            stats.average_latency_ms = (float)(s_loader->latency_sum_ms / (double)stats.completed);
+        }
+
+        std::lock_guard lock(s_loader->mutex);
+        s_loader->stats.bytes_uploaded_last_frame = uploaded_bytes;
+    }
+
+    void texture_loader::set_upload_budget(uint64_t bytes_per_frame)
+    {
+        std::lock_guard lock(s_loader->mutex);
+        s_loader->upload_budget = bytes_per_frame;
+    }
+
+    bool texture_loader::has_pending()
+    {
+        std::lock_guard lock(s_loader->mutex);
+        return s_loader->stats.pending > 0;
+    }
+
+    texture_load_stats texture_loader::get_stats()
+    {
+        std::lock_guard lock(s_loader->mutex);
+        return s_loader->stats;
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "moon/core/core.h"
+#include "moon/renderer/texture.h"
+
+#include <string_view>
+
+namespace moon
+{
+    struct texture_load_stats
+    {
+        uint32_t requested = 0;
+        uint32_t completed = 0;
+        uint32_t failed = 0;
+        uint32_t pending = 0;
+
+        // request to upload
+        float last_latency_ms = 0.0f;
+        float average_latency_ms = 0.0f;
+        float max_latency_ms = 0.0f;
+
+        uint64_t bytes_uploaded_last_frame = 0;
+    };
+
+    /// Decodes images on worker threads and uploads them on the main thread, a budgeted amount per frame
+    class MOON_API texture_loader
+    {
+    public:
+        static void init();
+        static void shutdown();
+
+        /// Queues path for decoding; texture gets the pixels through upload_image once its upload comes up.
+        /// Loads whose texture is released before then are dropped
+        static void load(const ref<texture2d>& texture, std::string_view path);
+
+        /// Uploads decoded images until this frame's byte budget is spent, at least one per call.
+        /// Called once per frame by application
+        static void process_uploads();
+        static void set_upload_budget(uint64_t bytes_per_frame);
+
+        [[nodiscard]] static bool has_pending();
+        static texture_load_stats get_stats();
+    };
+}
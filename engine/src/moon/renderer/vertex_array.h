@@ -14,6 +14,8 @@ namespace moon
         virtual void unbind() const = 0;
 
         virtual void add_vertex_buffer(ref<vertex_buffer> vbuf) = 0;
+        /// Attributes of this buffer advance once per instance instead of once per vertex
+        virtual void add_instance_buffer(ref<vertex_buffer> vbuf) = 0;
         virtual void set_index_buffer(ref<index_buffer> ibuf) = 0;
 
         virtual const std::vector<ref<vertex_buffer>>& get_vertex_buffers() const = 0;
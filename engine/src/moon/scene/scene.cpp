@@ -6,6 +6,8 @@
 
 #include <glm/glm.hpp>
 
+#include <chrono>
+
 namespace moon
 {
     scene::scene()
@@ -18,6 +20,44 @@ namespace moon
 
     }
 
+    template<typename T>
+    static void copy_component_storage(entt::registry& dst, entt::registry& src)
+    {
+        auto& storage = src.storage<T>();
+        // the sparse set and the component array of a storage iterate in the same order
+        const entt::sparse_set& entities = storage;
+        dst.insert<T>(entities.begin(), entities.end(), storage.begin());
+    }
+
+    ref<scene> scene::copy(const ref<scene>& other)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        const auto start = std::chrono::steady_clock::now();
+
+        ref<scene> new_scene = create_ref<scene>();
+        entt::registry& src = other->m_registry_;
+        entt::registry& dst = new_scene->m_registry_;
+
+        size_t entity_count = 0;
+        for (auto [e] : src.storage<entt::entity>().each())
+        {
+            dst.create(e);
+            entity_count++;
+        }
+
+        copy_component_storage<tag_component>(dst, src);
+        copy_component_storage<transform_component>(dst, src);
+        copy_component_storage<sprite_renderer_component>(dst, src);
+        copy_component_storage<camera_component>(dst, src);
+
+        const auto end = std::chrono::steady_clock::now();
+        MOON_CORE_TRACE("Copied scene ({0} entities) in {1:.3f} ms", entity_count,
+            std::chrono::duration<double, std::milli>(end - start).count());
+
+        return new_scene;
+    }
+
     entity scene::create_entity(std::string_view name)
     {
         entity e = { m_registry_.create(), this };
@@ -26,6 +66,17 @@ namespace moon
         return e;
     }
 
+    entity scene::get_primary_camera_entity()
+    {
+        auto view = m_registry_.view<camera_component>();
+        for (auto e : view)
+        {
+            if (view.get<camera_component>(e).primary)
+                return entity{ e, this };
+        }
+        return {};
+    }
+
     void scene::on_update(timestep ts)
     {
         // Render 2D
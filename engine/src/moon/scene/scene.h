@@ -16,13 +16,22 @@ namespace moon
         scene();
         ~scene();
 
+        /// Deep copy for play mode. Component storages are copied in bulk and entity identifiers are preserved,
+        /// so entity handles taken from the source stay meaningful in the copy.
+        static ref<scene> copy(const ref<scene>& other);
+
         entity create_entity(std::string_view name = "");
 
+        /// returns a null entity if no camera is marked primary
+        entity get_primary_camera_entity();
+
         void on_update(timestep ts);
 
     private:
         entt::registry m_registry_;
 
         friend class entity;
+        friend class scene_serializer;
+        friend class scene_streamer;
     };
 }
@@ -0,0 +1,473 @@
+#include "moonpch.h"
+#include "scene_serializer.h"
+
+#include "scene.h"
+#include "components.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace moon
+{
+    // .mscn layout, offsets are relative to the start of the file:
+    //   scene_file_header
+    //   scene_file_section[section_count]
+    //   per section: uint32_t local entity indices (omitted for dense sections), the component array,
+    //                and for tags a character table referenced by tag_record
+    // every array starts on a 16 byte boundary so it can be read in place from a mapping
+    static constexpr uint32_t s_scene_file_magic = 0x4E43534D; // "MSCN"
+    static constexpr uint32_t s_scene_file_version = 1;
+    static constexpr uint64_t s_scene_file_alignment = 16;
+    static constexpr uint32_t s_invalid_index = 0xffffffff;
+
+    enum class scene_section_type : uint32_t
+    {
+        transform = 1,
+        sprite_renderer = 2,
+        camera = 3,
+        tag = 4
+    };
+
+    struct scene_file_header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entity_count;
+        uint32_t section_count;
+    };
+
+    struct scene_file_section
+    {
+        scene_section_type type;
+        uint32_t element_size;
+        uint64_t count;
+        uint64_t indices_offset; // 0 for dense sections, where element i belongs to entity i
+        uint64_t data_offset;
+        uint64_t extra_offset;
+        uint64_t extra_size;
+    };
+
+    struct tag_record
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    static_assert(std::is_trivially_copyable_v<transform_component>);
+    static_assert(std::is_trivially_copyable_v<sprite_renderer_component>);
+    static_assert(std::is_trivially_copyable_v<camera_component>);
+
+    static uint64_t align_offset(uint64_t offset)
+    {
+        return (offset + s_scene_file_alignment - 1) & ~(s_scene_file_alignment - 1);
+    }
+
+    static bool in_bounds(const mapped_file& file, uint64_t offset, uint64_t size)
+    {
+        return offset <= file.size() && size <= file.size() - offset;
+    }
+
+    // ////////////////////////////////////////////////
+    // WRITING ////////////////////////////////////////
+
+    struct staged_section
+    {
+        scene_file_section header {};
+        std::vector<uint32_t> indices;
+        std::vector<uint8_t> data;
+        std::string extra;
+    };
+
+    static void collect_entities(const entt::sparse_set& set, std::vector<uint32_t>& remap, std::vector<entt::entity>& entities)
+    {
+        for (auto e : set)
+        {
+            const auto index = (size_t)entt::to_entity(e);
+            if (index >= remap.size())
+                remap.resize(index + 1, s_invalid_index);
+
+            if (remap[index] == s_invalid_index)
+            {
+                remap[index] = (uint32_t)entities.size();
+                entities.push_back(e);
+            }
+        }
+    }
+
+    static void stage_indices(staged_section& section, const entt::sparse_set& set, const std::vector<uint32_t>& remap, size_t entity_count)
+    {
+        bool dense = set.size() == entity_count;
+        section.indices.reserve(set.size());
+        for (auto e : set)
+        {
+            const uint32_t index = remap[(size_t)entt::to_entity(e)];
+            dense &= index == section.indices.size();
+            section.indices.push_back(index);
+        }
+
+        if (dense)
+            section.indices.clear();
+    }
+
+    template<typename T>
+    static void stage_record(uint8_t* out, const T& component)
+    {
+        std::memcpy(out, &component, sizeof(T));
+    }
+
+    // the padding after primary is never written, copying the whole struct would put stack garbage on disk
+    static void stage_record(uint8_t* out, const camera_component& component)
+    {
+        std::memcpy(out + offsetof(camera_component, camera), &component.camera, sizeof(component.camera));
+        std::memcpy(out + offsetof(camera_component, primary), &component.primary, sizeof(component.primary));
+    }
+
+    template<typename T>
+    static staged_section stage_pod_section(entt::registry& registry, scene_section_type type, const std::vector<uint32_t>& remap, size_t entity_count)
+    {
+        auto& storage = registry.storage<T>();
+
+        staged_section section;
+        section.header.type = type;
+        section.header.element_size = sizeof(T);
+        section.header.count = storage.size();
+
+        stage_indices(section, storage, remap, entity_count);
+
+        // zero filled, so bytes no record writes are the same on every save
+        section.data.assign(storage.size() * sizeof(T), 0);
+        uint8_t* out = section.data.data();
+        for (auto e : static_cast<const entt::sparse_set&>(storage))
+        {
+            stage_record(out, storage.get(e));
+            out += sizeof(T);
+        }
+
+        return section;
+    }
+
+    static staged_section stage_tag_section(entt::registry& registry, const std::vector<uint32_t>& remap, size_t entity_count)
+    {
+        auto& storage = registry.storage<tag_component>();
+
+        staged_section section;
+        section.header.type = scene_section_type::tag;
+        section.header.element_size = sizeof(tag_record);
+        section.header.count = storage.size();
+
+        stage_indices(section, storage, remap, entity_count);
+
+        section.data.resize(storage.size() * sizeof(tag_record));
+        uint8_t* out = section.data.data();
+        for (auto e : static_cast<const entt::sparse_set&>(storage))
+        {
+            const std::string& tag = storage.get(e).tag;
+            tag_record record { (uint32_t)section.extra.size(), (uint32_t)tag.size() };
+            section.extra += tag;
+
+            std::memcpy(out, &record, sizeof(tag_record));
+            out += sizeof(tag_record);
+        }
+
+        return section;
+    }
+
+    // ////////////////////////////////////////////////
+    // READING ////////////////////////////////////////
+
+    // resolves the entities a section's components belong to. Dense sections use the created entities directly
+    static bool resolve_targets(const mapped_file& file, const scene_file_section& section, const std::vector<entt::entity>& entities,
+        std::vector<entt::entity>& scratch, const entt::entity*& out_targets)
+    {
+        if (section.indices_offset == 0)
+        {
+            if (section.count > entities.size())
+                return false;
+
+            out_targets = entities.data();
+            return true;
+        }
+
+        if (!in_bounds(file, section.indices_offset, section.count * sizeof(uint32_t)))
+            return false;
+
+        const auto* indices = (const uint32_t*)(file.data() + section.indices_offset);
+        scratch.resize(section.count);
+        for (size_t i = 0; i < section.count; i++)
+        {
+            if (indices[i] >= entities.size())
+                return false;
+            scratch[i] = entities[indices[i]];
+        }
+
+        out_targets = scratch.data();
+        return true;
+    }
+
+    /// Checks that the component array of every known section lies inside the file and returns how many
+    /// components they hold. Every saved entity has a component, so this bounds entity_count before it is trusted
+    static bool validate_sections(const mapped_file& file, const scene_file_section* sections, uint32_t section_count,
+        uint64_t& out_component_count)
+    {
+        out_component_count = 0;
+        for (uint32_t i = 0; i < section_count; i++)
+        {
+            const scene_file_section& section = sections[i];
+            switch (section.type)
+            {
+            case scene_section_type::transform:
+            case scene_section_type::sprite_renderer:
+            case scene_section_type::camera:
+            case scene_section_type::tag:
+                // the exact element size is checked per type once the section is read
+                if (section.element_size == 0 || section.count > file.size() / section.element_size
+                    || !in_bounds(file, section.data_offset, section.count * section.element_size))
+                    return false;
+                out_component_count += section.count;
+                break;
+            default:
+                break;
+            }
+        }
+        return true;
+    }
+
+    template<typename T>
+    static bool insert_pod_section(entt::registry& registry, const mapped_file& file, const scene_file_section& section,
+        const std::vector<entt::entity>& entities, std::vector<entt::entity>& scratch)
+    {
+        if (section.element_size != sizeof(T))
+        {
+            MOON_CORE_ERROR("Scene section {0} has element size {1}, expected {2}", (uint32_t)section.type, section.element_size, sizeof(T));
+            return false;
+        }
+
+        if (section.data_offset % alignof(T) != 0 || !in_bounds(file, section.data_offset, section.count * sizeof(T)))
+            return false;
+
+        const entt::entity* targets = nullptr;
+        if (!resolve_targets(file, section, entities, scratch, targets))
+            return false;
+
+        // the component array is used in place as the copy source, no per-element decoding
+        const auto* components = (const T*)(file.data() + section.data_offset);
+        registry.insert<T>(targets, targets + section.count, components);
+        return true;
+    }
+
+    static bool insert_tag_section(entt::registry& registry, const mapped_file& file, const scene_file_section& section,
+        const std::vector<entt::entity>& entities, std::vector<entt::entity>& scratch)
+    {
+        if (section.element_size != sizeof(tag_record)
+            || !in_bounds(file, section.data_offset, section.count * sizeof(tag_record))
+            || !in_bounds(file, section.extra_offset, section.extra_size))
+            return false;
+
+        const entt::entity* targets = nullptr;
+        if (!resolve_targets(file, section, entities, scratch, targets))
+            return false;
+
+        const auto* records = (const tag_record*)(file.data() + section.data_offset);
+        const auto* chars = (const char*)(file.data() + section.extra_offset);
+        for (size_t i = 0; i < section.count; i++)
+        {
+            if ((uint64_t)records[i].offset + records[i].length > section.extra_size)
+                return false;
+
+            registry.emplace<tag_component>(targets[i], std::string_view(chars + records[i].offset, records[i].length));
+        }
+
+        return true;
+    }
+
+    // ////////////////////////////////////////////////
+    // SCENE SERIALIZER ///////////////////////////////
+
+    scene_serializer::scene_serializer(const ref<scene>& scene)
+        :
+        m_scene_(scene)
+    {}
+
+    bool scene_serializer::serialize(std::string_view filepath)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        entt::registry& registry = m_scene_->m_registry_;
+
+        // transforms go first so that the common case (every entity has one) is written as a dense section
+        std::vector<uint32_t> remap;
+        std::vector<entt::entity> entities;
+        collect_entities(registry.storage<transform_component>(), remap, entities);
+        collect_entities(registry.storage<sprite_renderer_component>(), remap, entities);
+        collect_entities(registry.storage<camera_component>(), remap, entities);
+        collect_entities(registry.storage<tag_component>(), remap, entities);
+
+        std::vector<staged_section> sections;
+        sections.push_back(stage_pod_section<transform_component>(registry, scene_section_type::transform, remap, entities.size()));
+        sections.push_back(stage_pod_section<sprite_renderer_component>(registry, scene_section_type::sprite_renderer, remap, entities.size()));
+        sections.push_back(stage_pod_section<camera_component>(registry, scene_section_type::camera, remap, entities.size()));
+        sections.push_back(stage_tag_section(registry, remap, entities.size()));
+
+        uint64_t offset = align_offset(sizeof(scene_file_header) + sections.size() * sizeof(scene_file_section));
+        for (auto& section : sections)
+        {
+            if (!section.indices.empty())
+            {
+                section.header.indices_offset = offset;
+                offset = align_offset(offset + section.indices.size() * sizeof(uint32_t));
+            }
+
+            section.header.data_offset = offset;
+            offset = align_offset(offset + section.data.size());
+
+            section.header.extra_offset = offset;
+            section.header.extra_size = section.extra.size();
+            offset = align_offset(offset + section.extra.size());
+        }
+
+        std::ofstream out(std::string(filepath), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            MOON_CORE_ERROR("Failed to open scene file for writing: {0}", filepath);
+            return false;
+        }
+
+        uint64_t written = 0;
+        auto write = [&](const void* data, uint64_t size)
+        {
+            out.write((const char*)data, (std::streamsize)size);
+            written += size;
+        };
+        auto pad_to = [&](uint64_t target)
+        {
+            static constexpr char zeros[s_scene_file_alignment] = {};
+            while (written < target)
+                write(zeros, std::min<uint64_t>(target - written, s_scene_file_alignment));
+        };
+
+        scene_file_header header { s_scene_file_magic, s_scene_file_version, (uint32_t)entities.size(), (uint32_t)sections.size() };
+        write(&header, sizeof(header));
+        for (const auto& section : sections)
+            write(&section.header, sizeof(scene_file_section));
+
+        for (const auto& section : sections)
+        {
+            if (!section.indices.empty())
+            {
+                pad_to(section.header.indices_offset);
+                write(section.indices.data(), section.indices.size() * sizeof(uint32_t));
+            }
+
+            pad_to(section.header.data_offset);
+            write(section.data.data(), section.data.size());
+
+            pad_to(section.header.extra_offset);
+            write(section.extra.data(), section.extra.size());
+        }
+        pad_to(offset);
+
+        if (!out)
+        {
+            MOON_CORE_ERROR("Failed to write scene file: {0}", filepath);
+            return false;
+        }
+
+        MOON_CORE_INFO("Saved scene {0} ({1} entities, {2} bytes)", filepath, entities.size(), written);
+        return true;
+    }
+
+    bool scene_serializer::deserialize(std::string_view filepath)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        const auto start = std::chrono::steady_clock::now();
+
+        mapped_file file(filepath);
+        if (!file.is_open())
+            return false;
+
+        if (!deserialize(file))
+        {
+            MOON_CORE_ERROR("Failed to load scene file: {0}", filepath);
+            return false;
+        }
+
+        const auto end = std::chrono::steady_clock::now();
+        const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        const double mb = (double)file.size() / (1024.0 * 1024.0);
+        MOON_CORE_INFO("Loaded scene {0} ({1:.2f} MB) in {2:.3f} ms ({3:.1f} MB/s)", filepath, mb, ms, ms > 0.0 ? mb / (ms / 1000.0) : 0.0);
+        return true;
+    }
+
+    bool scene_serializer::deserialize(const mapped_file& file, std::vector<entt::entity>* out_entities)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        if (!in_bounds(file, 0, sizeof(scene_file_header)))
+            return false;
+
+        const auto* header = (const scene_file_header*)file.data();
+        if (header->magic != s_scene_file_magic || header->version != s_scene_file_version)
+        {
+            MOON_CORE_ERROR("Unsupported scene file (magic {0:#x}, version {1})", header->magic, header->version);
+            return false;
+        }
+
+        if (!in_bounds(file, sizeof(scene_file_header), (uint64_t)header->section_count * sizeof(scene_file_section)))
+            return false;
+
+        const auto* sections = (const scene_file_section*)(file.data() + sizeof(scene_file_header));
+
+        // entity_count sizes an allocation, so it is checked against the sections before anything is created
+        uint64_t component_count;
+        if (!validate_sections(file, sections, header->section_count, component_count) || header->entity_count > component_count)
+        {
+            MOON_CORE_ERROR("Scene file is corrupt or truncated");
+            return false;
+        }
+
+        entt::registry& registry = m_scene_->m_registry_;
+
+        std::vector<entt::entity> entities(header->entity_count);
+        registry.create(entities.begin(), entities.end());
+
+        std::vector<entt::entity> scratch;
+        bool ok = true;
+        for (uint32_t i = 0; i < header->section_count && ok; i++)
+        {
+            const scene_file_section& section = sections[i];
+            switch (section.type)
+            {
+            case scene_section_type::transform:
+                ok = insert_pod_section<transform_component>(registry, file, section, entities, scratch);
+                break;
+            case scene_section_type::sprite_renderer:
+                ok = insert_pod_section<sprite_renderer_component>(registry, file, section, entities, scratch);
+                break;
+            case scene_section_type::camera:
+                ok = insert_pod_section<camera_component>(registry, file, section, entities, scratch);
+                break;
+            case scene_section_type::tag:
+                ok = insert_tag_section(registry, file, section, entities, scratch);
+                break;
+            default:
+                MOON_CORE_WARN("Skipping unknown scene section {0}", (uint32_t)section.type);
+                break;
+            }
+        }
+
+        if (!ok)
+        {
+            MOON_CORE_ERROR("Scene file is corrupt or truncated");
+            registry.destroy(entities.begin(), entities.end());
+            return false;
+        }
+
+        if (out_entities)
+            *out_entities = std::move(entities);
+
+        return true;
+    }
+}
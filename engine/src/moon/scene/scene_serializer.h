@@ -0,0 +1,33 @@
+#pragma once
+
+#include "moon/core/core.h"
+#include "moon/core/mapped_file.h"
+
+#include <entt/entt.hpp>
+
+#include <string_view>
+#include <vector>
+
+namespace moon
+{
+    class scene;
+
+    /// Binary scene persistence (.mscn).
+    /// Trivially copyable components are stored as contiguous, aligned arrays, so loading maps the file and
+    /// bulk-inserts each array straight into entt storage instead of deserializing component by component.
+    /// Loaded entities are appended to the scene; deserialize into a fresh scene to replace its contents.
+    class MOON_API scene_serializer
+    {
+    public:
+        explicit scene_serializer(const ref<scene>& scene);
+
+        bool serialize(std::string_view filepath);
+
+        bool deserialize(std::string_view filepath);
+        /// out_entities receives the created entities in file order
+        bool deserialize(const mapped_file& file, std::vector<entt::entity>* out_entities = nullptr);
+
+    private:
+        ref<scene> m_scene_;
+    };
+}
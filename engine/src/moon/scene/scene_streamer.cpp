@@ -0,0 +1,319 @@
+#include "moonpch.h"
+#include "scene_streamer.h"
+
+#include "scene.h"
+#include "entity.h"
+#include "components.h"
+#include "scene_serializer.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+
+namespace moon
+{
+    static int32_t chunk_distance(const glm::ivec2& a, const glm::ivec2& b)
+    {
+        return std::max(std::abs(a.x - b.x), std::abs(a.y - b.y));
+    }
+
+    scene_streamer::scene_streamer(const ref<scene>& scene, const scene_streaming_spec& spec)
+        :
+        m_scene_(scene),
+        m_spec_(spec)
+    {
+        MOON_CORE_ASSERT(m_spec_.chunk_size > 0.0f, "Chunk size must be positive!");
+
+        m_io_thread_ = std::thread([this]() { io_thread_main(); });
+    }
+
+    scene_streamer::~scene_streamer()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        {
+            std::lock_guard lock(m_io_mutex_);
+            m_io_stop_ = true;
+        }
+        m_io_cv_.notify_one();
+        m_io_thread_.join();
+
+        for (auto& [key, c] : m_chunks_)
+        {
+            if (c.state == chunk_state::resident)
+                unload_chunk(c);
+        }
+    }
+
+    void scene_streamer::on_update()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        collect_io_results();
+
+        glm::vec2 camera_position;
+        if (!get_camera_position(camera_position))
+            return;
+
+        const glm::ivec2 center = world_to_chunk(camera_position);
+
+        uint32_t operations = 0;
+        unload_distant_chunks(center, operations);
+        request_chunks(center);
+        instantiate_ready_chunks(center, operations);
+
+        m_stats_.resident_chunks = 0;
+        m_stats_.pending_chunks = 0;
+        for (const auto& [key, c] : m_chunks_)
+        {
+            if (c.state == chunk_state::resident)
+                m_stats_.resident_chunks++;
+            else if (c.state == chunk_state::loading || c.state == chunk_state::ready)
+                m_stats_.pending_chunks++;
+        }
+    }
+
+    glm::ivec2 scene_streamer::world_to_chunk(const glm::vec2& position) const
+    {
+        return { (int32_t)std::floor(position.x / m_spec_.chunk_size), (int32_t)std::floor(position.y / m_spec_.chunk_size) };
+    }
+
+    uint64_t scene_streamer::make_key(const glm::ivec2& coords)
+    {
+        return ((uint64_t)(uint32_t)coords.x << 32) | (uint64_t)(uint32_t)coords.y;
+    }
+
+    std::string scene_streamer::get_chunk_path(const glm::ivec2& coords) const
+    {
+        return (std::filesystem::path(m_spec_.chunk_directory) / (std::to_string(coords.x) + "_" + std::to_string(coords.y) + ".mscn")).string();
+    }
+
+    bool scene_streamer::get_camera_position(glm::vec2& out_position) const
+    {
+        entity camera_entity = m_scene_->get_primary_camera_entity();
+        if (!camera_entity)
+            return false;
+
+        const glm::mat4& transform = camera_entity.get_component<transform_component>();
+        out_position = { transform[3].x, transform[3].y };
+        return true;
+    }
+
+    void scene_streamer::collect_io_results()
+    {
+        std::vector<io_result> results;
+        {
+            std::lock_guard lock(m_io_mutex_);
+            results.swap(m_io_results_);
+        }
+
+        for (auto& result : results)
+        {
+            auto it = m_chunks_.find(result.key);
+            // the chunk was dropped while its file was being read
+            if (it == m_chunks_.end())
+                continue;
+
+            chunk& c = it->second;
+            if (result.file.is_open())
+            {
+                c.size = result.file.size();
+                c.file = std::move(result.file);
+                c.state = chunk_state::ready;
+            }
+            else
+            {
+                c.state = chunk_state::missing;
+            }
+        }
+    }
+
+    void scene_streamer::request_chunks(const glm::ivec2& center)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        uint64_t committed_bytes = 0;
+        for (const auto& [key, c] : m_chunks_)
+            committed_bytes += c.size;
+
+        // nearest rings first, so a tight budget keeps the chunks around the camera
+        std::vector<std::pair<uint64_t, std::string>> requests;
+        // chunk sizes are unknown until mapped, so stop requesting once the budget is used up
+        for (int32_t ring = 0; ring <= m_spec_.load_radius && committed_bytes < m_spec_.memory_budget; ring++)
+        {
+            for (int32_t y = center.y - ring; y <= center.y + ring; y++)
+            {
+                for (int32_t x = center.x - ring; x <= center.x + ring; x++)
+                {
+                    const glm::ivec2 coords { x, y };
+                    if (chunk_distance(coords, center) != ring)
+                        continue;
+
+                    const uint64_t key = make_key(coords);
+                    if (m_chunks_.contains(key))
+                        continue;
+
+                    chunk& c = m_chunks_[key];
+                    c.coords = coords;
+                    c.state = chunk_state::loading;
+                    requests.emplace_back(key, get_chunk_path(coords));
+                }
+            }
+        }
+
+        if (requests.empty())
+            return;
+
+        {
+            std::lock_guard lock(m_io_mutex_);
+            for (auto& request : requests)
+                m_io_requests_.push_back(std::move(request));
+        }
+        m_io_cv_.notify_one();
+    }
+
+    void scene_streamer::instantiate_ready_chunks(const glm::ivec2& center, uint32_t& operations)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        std::vector<chunk*> ready;
+        for (auto& [key, c] : m_chunks_)
+        {
+            if (c.state == chunk_state::ready)
+                ready.push_back(&c);
+        }
+
+        std::ranges::sort(ready, [&](const chunk* a, const chunk* b)
+        {
+            return chunk_distance(a->coords, center) < chunk_distance(b->coords, center);
+        });
+
+        uint64_t resident_bytes = m_stats_.resident_bytes;
+        scene_serializer serializer(m_scene_);
+        for (chunk* c : ready)
+        {
+            if (operations >= m_spec_.max_chunk_operations_per_frame)
+                break;
+
+            if (resident_bytes + c->size > m_spec_.memory_budget)
+            {
+                // keep it mapped; it is instantiated once distant chunks free up the budget
+                continue;
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            const bool loaded = serializer.deserialize(c->file, &c->entities);
+            const float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            // the registry holds its own copy of everything now
+            c->file.close();
+            operations++;
+
+            if (!loaded)
+            {
+                MOON_CORE_ERROR("Failed to instantiate scene chunk ({0}, {1})", c->coords.x, c->coords.y);
+                c->state = chunk_state::missing;
+                c->size = 0;
+                continue;
+            }
+
+            c->state = chunk_state::resident;
+            resident_bytes += c->size;
+
+            m_stats_.chunks_loaded++;
+            m_stats_.last_instantiate_ms = ms;
+            m_stats_.max_instantiate_ms = std::max(m_stats_.max_instantiate_ms, ms);
+        }
+
+        m_stats_.resident_bytes = resident_bytes;
+    }
+
+    void scene_streamer::unload_distant_chunks(const glm::ivec2& center, uint32_t& operations)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        // one chunk of hysteresis, so moving back and forth over a border doesn't reload chunks every frame
+        const int32_t unload_radius = m_spec_.load_radius + 1;
+
+        std::vector<uint64_t> distant;
+        for (auto& [key, c] : m_chunks_)
+        {
+            if (chunk_distance(c.coords, center) > unload_radius)
+                distant.push_back(key);
+        }
+
+        std::ranges::sort(distant, [&](uint64_t a, uint64_t b)
+        {
+            return chunk_distance(m_chunks_[a].coords, center) > chunk_distance(m_chunks_[b].coords, center);
+        });
+
+        for (uint64_t key : distant)
+        {
+            chunk& c = m_chunks_[key];
+            if (c.state == chunk_state::resident)
+            {
+                if (operations >= m_spec_.max_chunk_operations_per_frame)
+                    continue;
+
+                unload_chunk(c);
+                operations++;
+            }
+            else if (c.state == chunk_state::loading)
+            {
+                // leave it in place until the io thread reports back, otherwise it would be requested twice
+                continue;
+            }
+
+            m_chunks_.erase(key);
+        }
+    }
+
+    void scene_streamer::unload_chunk(chunk& c)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        entt::registry& registry = m_scene_->m_registry_;
+        for (auto e : c.entities)
+        {
+            // gameplay code may already have destroyed some of them
+            if (registry.valid(e))
+                registry.destroy(e);
+        }
+
+        c.entities.clear();
+        m_stats_.resident_bytes -= std::min(m_stats_.resident_bytes, c.size);
+        m_stats_.chunks_unloaded++;
+    }
+
+    void scene_streamer::io_thread_main()
+    {
+        while (true)
+        {
+            std::pair<uint64_t, std::string> request;
+            {
+                std::unique_lock lock(m_io_mutex_);
+                m_io_cv_.wait(lock, [this]() { return m_io_stop_ || !m_io_requests_.empty(); });
+                if (m_io_stop_)
+                    return;
+
+                request = std::move(m_io_requests_.front());
+                m_io_requests_.pop_front();
+            }
+
+            io_result result { request.first, {} };
+            if (std::filesystem::exists(request.second) && result.file.open(request.second))
+            {
+                // fault every page in here, so the main thread's bulk insert never waits on the disk
+                result.file.prefetch();
+                constexpr size_t page_size = 4096;
+                volatile uint8_t sink = 0;
+                for (size_t offset = 0; offset < result.file.size(); offset += page_size)
+                    sink = (uint8_t)(sink + result.file.data()[offset]);
+            }
+
+            std::lock_guard lock(m_io_mutex_);
+            m_io_results_.push_back(std::move(result));
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "moon/core/core.h"
+#include "moon/core/mapped_file.h"
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace moon
+{
+    class scene;
+
+    struct MOON_API scene_streaming_spec
+    {
+        /// chunk files are named "<x>_<y>.mscn" inside this directory, written with scene_serializer
+        std::string chunk_directory;
+        /// world units covered by one chunk along x and y
+        float chunk_size = 64.0f;
+        /// chunks within this many cells (chebyshev distance) of the camera chunk are kept resident
+        int32_t load_radius = 2;
+        /// upper bound on the estimated resident size of all chunks, in bytes
+        uint64_t memory_budget = 256ull * 1024 * 1024;
+        /// instantiations/unloads allowed per frame, so region transitions are spread over several frames
+        uint32_t max_chunk_operations_per_frame = 2;
+    };
+
+    /// Streams a grid of scene chunks in and out of a scene around the primary camera.
+    /// File I/O (mapping and paging in) happens on a background thread; the main thread only bulk-inserts
+    /// ready chunks into the registry, a bounded number per frame.
+    class MOON_API scene_streamer
+    {
+    public:
+        scene_streamer(const ref<scene>& scene, const scene_streaming_spec& spec);
+        ~scene_streamer();
+
+        scene_streamer(const scene_streamer&) = delete;
+        scene_streamer& operator=(const scene_streamer&) = delete;
+
+        /// call once per frame on the main thread, before the scene is updated
+        void on_update();
+
+        struct statistics
+        {
+            uint32_t resident_chunks = 0;
+            uint32_t pending_chunks = 0;
+            uint64_t resident_bytes = 0;
+            uint64_t chunks_loaded = 0;
+            uint64_t chunks_unloaded = 0;
+            float last_instantiate_ms = 0.0f;
+            float max_instantiate_ms = 0.0f;
+        };
+        [[nodiscard]] const statistics& get_stats() const { return m_stats_; }
+
+        [[nodiscard]] glm::ivec2 world_to_chunk(const glm::vec2& position) const;
+
+    private:
+        enum class chunk_state : uint8_t
+        {
+            loading,
+            ready,
+            resident,
+            missing
+        };
+
+        struct chunk
+        {
+            glm::ivec2 coords {0};
+            chunk_state state = chunk_state::loading;
+            mapped_file file;
+            std::vector<entt::entity> entities;
+            uint64_t size = 0;
+        };
+
+        struct io_result
+        {
+            uint64_t key;
+            mapped_file file;
+        };
+
+        static uint64_t make_key(const glm::ivec2& coords);
+        std::string get_chunk_path(const glm::ivec2& coords) const;
+
+        bool get_camera_position(glm::vec2& out_position) const;
+        void collect_io_results();
+        void request_chunks(const glm::ivec2& center);
+        void instantiate_ready_chunks(const glm::ivec2& center, uint32_t& operations);
+        void unload_distant_chunks(const glm::ivec2& center, uint32_t& operations);
+        void unload_chunk(chunk& c);
+
+        void io_thread_main();
+
+    private:
+        ref<scene> m_scene_;
+        scene_streaming_spec m_spec_;
+        std::unordered_map<uint64_t, chunk> m_chunks_;
+        statistics m_stats_;
+
+        std::thread m_io_thread_;
+        std::mutex m_io_mutex_;
+        std::condition_variable m_io_cv_;
+        std::deque<std::pair<uint64_t, std::string>> m_io_requests_;
+        std::vector<io_result> m_io_results_;
+        bool m_io_stop_ = false;
+    };
+}
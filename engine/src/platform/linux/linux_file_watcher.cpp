@@ -0,0 +1,90 @@
+#include "moonpch.h"
+
+#include "moon/core/file_watcher.h"
+
+#include <mutex>
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace moon
+{
+    struct file_watcher::impl
+    {
+        int fd = -1;
+
+        std::mutex mutex;
+        std::unordered_map<int, std::string> directories; // by watch descriptor
+    };
+
+    file_watcher::file_watcher()
+        :
+        impl_(create_scope<impl>())
+    {
+        impl_->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (impl_->fd < 0)
+            MOON_CORE_ERROR("inotify_init1 failed, file changes won't be detected");
+    }
+
+    file_watcher::~file_watcher()
+    {
+        // closing the instance drops all of its watches
+        if (impl_->fd >= 0)
+            close(impl_->fd);
+    }
+
+    bool file_watcher::add_directory(std::string_view directory)
+    {
+        if (impl_->fd < 0)
+            return false;
+
+        const std::string directory_str(directory);
+        // editors either write in place or save to a temporary file and rename it over the original
+        const int wd = inotify_add_watch(impl_->fd, directory_str.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd < 0)
+        {
+            MOON_CORE_ERROR("Failed to watch directory: {0}", directory);
+            return false;
+        }
+
+        std::lock_guard lock(impl_->mutex);
+        impl_->directories[wd] = directory_str;
+        return true;
+    }
+
+    void file_watcher::wait(std::vector<std::string>& out_changed, uint32_t timeout_ms)
+    {
+        if (impl_->fd < 0)
+        {
+            usleep(timeout_ms * 1000);
+            return;
+        }
+
+        pollfd pfd { impl_->fd, POLLIN, 0 };
+        if (poll(&pfd, 1, (int)timeout_ms) <= 0)
+            return;
+
+        alignas(inotify_event) char buffer[4096];
+        while (true)
+        {
+            const ssize_t length = read(impl_->fd, buffer, sizeof(buffer));
+            if (length <= 0)
+                break;
+
+            std::lock_guard lock(impl_->mutex);
+            for (ssize_t offset = 0; offset < length;)
+            {
+                const auto* e = (const inotify_event*)(buffer + offset);
+                offset += (ssize_t)(sizeof(inotify_event) + e->len);
+
+                if (e->len == 0 || (e->mask & IN_ISDIR))
+                    continue;
+
+                auto it = impl_->directories.find(e->wd);
+                if (it != impl_->directories.end())
+                    out_changed.push_back(it->second + "/" + e->name);
+            }
+        }
+    }
+}
@@ -10,6 +10,8 @@ namespace moon
     // VERTEX BUFFER ///////////////////////////////////
 
     opengl_vertex_buffer::opengl_vertex_buffer(uint32_t size)
+        :
+        size_(size), dynamic_(true)
     {
         MOON_PROFILE_FUNCTION();
 
@@ -19,6 +21,8 @@ namespace moon
     }
 
     opengl_vertex_buffer::opengl_vertex_buffer(const float* vertices, uint32_t size)
+        :
+        size_(size)
     {
         MOON_PROFILE_FUNCTION();
 
@@ -52,8 +56,12 @@ namespace moon
     {
         MOON_PROFILE_FUNCTION();
 
-        glBindBuffer(GL_ARRAY_BUFFER, renderer_id_);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+        MOON_CORE_ASSERT(size <= size_, "Data doesn't fit into the vertex buffer!");
+
+        // fresh storage for the new contents, the driver frees the old once draws using it are done
+        if (dynamic_)
+            glNamedBufferData(renderer_id_, size_, nullptr, GL_DYNAMIC_DRAW);
+        glNamedBufferSubData(renderer_id_, 0, size, data);
     }
 
     // ////////////////////////////////////////////////
@@ -90,4 +98,34 @@ namespace moon
 
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
+
+    // ////////////////////////////////////////////////
+    // UNIFORM BUFFER /////////////////////////////////
+
+    opengl_uniform_buffer::opengl_uniform_buffer(uint32_t size, uint32_t binding)
+        :
+        size_(size)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        glCreateBuffers(1, &renderer_id_);
+        glNamedBufferData(renderer_id_, size, nullptr, GL_DYNAMIC_DRAW);
+        // stays bound for the buffer's lifetime, shaders find it through their block binding
+        glBindBufferBase(GL_UNIFORM_BUFFER, binding, renderer_id_);
+    }
+
+    opengl_uniform_buffer::~opengl_uniform_buffer()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        glDeleteBuffers(1, &renderer_id_);
+    }
+
+    void opengl_uniform_buffer::set_data(const void* data, uint32_t size, uint32_t offset)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        MOON_CORE_ASSERT(offset + size <= size_, "Data exceeds the uniform buffer!");
+        glNamedBufferSubData(renderer_id_, offset, size, data);
+    }
 }
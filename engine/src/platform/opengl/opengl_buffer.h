@@ -21,6 +21,9 @@ namespace moon
 
     private:
         uint32_t renderer_id_{0};
+        uint32_t size_{0};
+        // created with a size and filled by set_data, so its storage can be orphaned
+        bool dynamic_{false};
         buffer_layout layout_;
     };
 
@@ -38,4 +41,17 @@ namespace moon
         uint32_t renderer_id_{0};
         uint32_t count_;
     };
+
+    class opengl_uniform_buffer : public uniform_buffer
+    {
+    public:
+        opengl_uniform_buffer(uint32_t size, uint32_t binding);
+        ~opengl_uniform_buffer() override;
+
+        void set_data(const void* data, uint32_t size, uint32_t offset = 0) override;
+
+    private:
+        uint32_t renderer_id_{0};
+        uint32_t size_;
+    };
 }
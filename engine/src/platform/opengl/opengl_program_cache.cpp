@@ -0,0 +1,207 @@
+#include "moonpch.h"
+#include "opengl_program_cache.h"
+
+#include "moon/core/mapped_file.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace moon
+{
+    static constexpr uint32_t s_program_binary_magic = 0x4250534D; // "MSPB"
+    static constexpr uint32_t s_program_binary_version = 1;
+    static constexpr const char* s_program_cache_directory = "cache/shaders";
+
+    struct program_binary_header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t source_hash;
+        uint64_t driver_hash;
+        uint32_t binary_format;
+        uint32_t binary_size;
+    };
+
+    struct program_cache_data
+    {
+        bool initialized = false;
+        // drivers without binary formats can't use the cache
+        bool supported = false;
+        uint64_t driver_hash = 0;
+
+        program_cache_stats stats;
+    };
+
+    static program_cache_data s_program_cache;
+
+    static uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+    {
+        const auto* bytes = (const uint8_t*)data;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    static void init_program_cache()
+    {
+        s_program_cache.initialized = true;
+
+        GLint format_count = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+        s_program_cache.supported = format_count > 0;
+        if (!s_program_cache.supported)
+        {
+            MOON_CORE_WARN("The driver offers no program binary formats, shaders are compiled on every launch");
+            return;
+        }
+
+        uint64_t hash = fnv1a(nullptr, 0);
+        for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+        {
+            const char* value = (const char*)glGetString(name);
+            if (value)
+                hash = fnv1a(value, strlen(value) + 1, hash);
+        }
+        s_program_cache.driver_hash = hash;
+
+        std::error_code ec;
+        std::filesystem::create_directories(s_program_cache_directory, ec);
+    }
+
+    static bool program_cache_available()
+    {
+        if (!s_program_cache.initialized)
+            init_program_cache();
+        return s_program_cache.supported;
+    }
+
+    static std::string get_cache_path(uint64_t source_hash)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "/%016llx.bin", (unsigned long long)source_hash);
+        return std::string(s_program_cache_directory) + name;
+    }
+
+    uint64_t opengl_program_cache::hash_sources(const std::unordered_map<GLenum, std::string>& shader_sources)
+    {
+        // the map's order isn't stable, so stages are combined in a fixed order
+        uint64_t hash = fnv1a(nullptr, 0);
+        for (GLenum type : { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER })
+        {
+            auto it = shader_sources.find(type);
+            if (it == shader_sources.end())
+                continue;
+
+            hash = fnv1a(&type, sizeof(type), hash);
+            hash = fnv1a(it->second.data(), it->second.size(), hash);
+        }
+        return hash;
+    }
+
+    GLuint opengl_program_cache::load(uint64_t source_hash)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        if (!program_cache_available())
+            return 0;
+
+        const std::string path = get_cache_path(source_hash);
+        std::error_code ec;
+        if (!std::filesystem::exists(path, ec))
+        {
+            s_program_cache.stats.misses++;
+            return 0;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+
+        mapped_file file;
+        program_binary_header header {};
+        if (!file.open(path) || file.size() < sizeof(header))
+        {
+            s_program_cache.stats.misses++;
+            return 0;
+        }
+        memcpy(&header, file.data(), sizeof(header));
+
+        if (header.magic != s_program_binary_magic || header.version != s_program_binary_version ||
+            header.source_hash != source_hash || header.driver_hash != s_program_cache.driver_hash ||
+            file.size() != sizeof(header) + header.binary_size)
+        {
+            // stale entry, the compile that follows overwrites it
+            s_program_cache.stats.misses++;
+            return 0;
+        }
+
+        GLuint program = glCreateProgram();
+        glProgramBinary(program, header.binary_format, file.data() + sizeof(header), (GLsizei)header.binary_size);
+
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (linked == GL_FALSE)
+        {
+            glDeleteProgram(program);
+            s_program_cache.stats.rejected++;
+            s_program_cache.stats.misses++;
+            return 0;
+        }
+
+        s_program_cache.stats.hits++;
+        s_program_cache.stats.load_ms += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return program;
+    }
+
+    void opengl_program_cache::store(uint64_t source_hash, GLuint program)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        if (!program_cache_available())
+            return;
+
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return;
+
+        std::vector<uint8_t> binary((size_t)length);
+        GLenum binary_format = 0;
+        glGetProgramBinary(program, length, &length, &binary_format, binary.data());
+
+        program_binary_header header {};
+        header.magic = s_program_binary_magic;
+        header.version = s_program_binary_version;
+        header.source_hash = source_hash;
+        header.driver_hash = s_program_cache.driver_hash;
+        header.binary_format = binary_format;
+        header.binary_size = (uint32_t)length;
+
+        // written aside and renamed, so a crash mid-write never leaves a truncated entry behind
+        const std::string path = get_cache_path(source_hash);
+        const std::string temp_path = path + ".tmp";
+        {
+            std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+            out.write((const char*)&header, sizeof(header));
+            out.write((const char*)binary.data(), length);
+            if (!out)
+            {
+                MOON_CORE_WARN("Failed to write program binary: {0}", path);
+                return;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(temp_path, path, ec);
+        if (ec)
+            MOON_CORE_WARN("Failed to write program binary: {0}", path);
+    }
+
+    program_cache_stats opengl_program_cache::get_stats()
+    {
+        return s_program_cache.stats;
+    }
+}
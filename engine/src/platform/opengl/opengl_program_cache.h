@@ -0,0 +1,38 @@
+#pragma once
+
+#include "moon/core/core.h"
+
+#include <string>
+#include <unordered_map>
+#include <glad/glad.h>
+
+namespace moon
+{
+    struct program_cache_stats
+    {
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+        // binaries the driver refused, usually after a driver update
+        uint32_t rejected = 0;
+
+        float load_ms = 0.0f;
+    };
+
+    /// Keeps linked program binaries on disk, so later launches skip compiling and linking.
+    /// Entries are keyed on a hash of the shader sources and checked against the driver's vendor, renderer
+    /// and version; anything stale or refused falls back to a regular compile, which replaces the entry.
+    /// Main thread only, needs a current context
+    class opengl_program_cache
+    {
+    public:
+        static uint64_t hash_sources(const std::unordered_map<GLenum, std::string>& shader_sources);
+
+        /// Returns a linked program, 0 if there is no usable binary for source_hash
+        static GLuint load(uint64_t source_hash);
+        /// The program must have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set
+        static void store(uint64_t source_hash, GLuint program);
+
+        /// Compiles finish on first use, so their times are logged per shader rather than summed here
+        static program_cache_stats get_stats();
+    };
+}
@@ -51,6 +51,14 @@ namespace moon
         glViewport(x, y, width, height);
     }
 
+    glm::vec4 opengl_renderer_api::get_viewport() const
+    {
+        // framebuffers set their own viewport when bound, so ask gl instead of remembering set_viewport
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        return { (float)viewport[0], (float)viewport[1], (float)viewport[2], (float)viewport[3] };
+    }
+
     void opengl_renderer_api::set_clear_color(const glm::vec4& color)
     {
         glClearColor(color.r, color.g, color.b, color.a);
@@ -67,4 +75,25 @@ namespace moon
         glDrawElements(GL_TRIANGLES, (GLsizei)count, GL_UNSIGNED_INT, nullptr);
         //glBindTexture(GL_TEXTURE_2D, 0);
     }
+
+    void opengl_renderer_api::draw_indexed_instanced(const ref<vertex_array>& vertex_array, uint32_t index_count, uint32_t instance_count)
+    {
+        glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)index_count, GL_UNSIGNED_INT, nullptr, (GLsizei)instance_count);
+    }
+
+    void opengl_renderer_api::draw_lines(const ref<vertex_array>& vertex_array, uint32_t vertex_count)
+    {
+        glDrawArrays(GL_LINES, 0, (GLsizei)vertex_count);
+    }
+
+    void opengl_renderer_api::set_line_width(float width)
+    {
+        // core profiles only guarantee 1.0, wider lines are clamped by the driver
+        glLineWidth(width);
+    }
+
+    void opengl_renderer_api::set_depth_write(bool enabled)
+    {
+        glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    }
 }
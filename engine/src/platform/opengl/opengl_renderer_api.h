@@ -12,10 +12,16 @@ namespace moon
 
         void init() override;
         void set_viewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+        [[nodiscard]] glm::vec4 get_viewport() const override;
 
         void set_clear_color(const glm::vec4& color) override;
         void clear() override;
 
         void draw_indexed(const ref<vertex_array>& vertex_array, uint32_t index_count) override;
+        void draw_indexed_instanced(const ref<vertex_array>& vertex_array, uint32_t index_count, uint32_t instance_count) override;
+        void draw_lines(const ref<vertex_array>& vertex_array, uint32_t vertex_count) override;
+
+        void set_line_width(float width) override;
+        void set_depth_write(bool enabled) override;
     };
 }
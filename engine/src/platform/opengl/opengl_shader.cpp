@@ -3,11 +3,19 @@
 
 #include "renderer/camera.h"
 #include "renderer/camera.h"
+#include "moon/asset/asset_archive.h"
+#include "opengl_program_cache.h"
+#include "moon/renderer/renderer.h"
+#include "moon/renderer/shader_preprocessor.h"
 
 #include <filesystem>
 #include <glad/glad.h>
+#include <GLFW/glfw3.h>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <chrono>
+#include <cstddef>
+#include <cstring>
 #include <fstream>
 #include <filesystem>
 
@@ -20,18 +28,16 @@ namespace moon
         else if (type == "fragment"|| type == "pixel")
             return GL_FRAGMENT_SHADER;
 
-        MOON_CORE_ASSERT(false, "Unknown shader type! {0}", type);
         return 0;
     }
 
-    opengl_shader::opengl_shader(std::string_view filepath)
+    opengl_shader::opengl_shader(std::string_view filepath, std::vector<std::string> defines)
+        :
+        filepath_(filepath),
+        defines_(std::move(defines))
     {
         MOON_PROFILE_FUNCTION();
 
-        std::string shader_source = read_file(filepath);
-        auto shader_sources = preprocess(shader_source);
-        compile(shader_sources);
-
         // Extract the name from the filepath
         auto last_slash = filepath.find_last_of("/\\");
         last_slash = last_slash == std::string::npos ? 0 : last_slash + 1;
@@ -39,6 +45,15 @@ namespace moon
 
         auto count = last_dot == std::string::npos ? filepath.size() - last_slash : last_dot - last_slash;
         name_ = filepath.substr(last_slash, count);
+        if (!defines_.empty())
+            name_ += "[" + shader_preprocessor::make_permutation_key(defines_) + "]";
+
+        std::unordered_map<GLenum, std::string> shader_sources;
+        const bool loaded = load_sources(shader_sources);
+        MOON_CORE_ASSERT(loaded, "Failed to preprocess shader!");
+
+        // finished on first use, so shaders created back to back compile concurrently
+        pending_ = start_compile(shader_sources);
     }
 
     opengl_shader::opengl_shader(std::string_view name, std::string_view vertex_src, std::string_view fragment_src)
@@ -50,13 +65,19 @@ namespace moon
         std::unordered_map<GLenum, std::string> sources;
         sources[GL_VERTEX_SHADER] = std::string(vertex_src);
         sources[GL_FRAGMENT_SHADER] = std::string(fragment_src);
-        compile(sources);
+        pending_ = start_compile(sources);
     }
 
     opengl_shader::~opengl_shader()
     {
         MOON_PROFILE_FUNCTION();
 
+        if (pending_)
+        {
+            for (auto id : pending_->shaders)
+                glDeleteShader(id);
+            glDeleteProgram(pending_->program);
+        }
         glDeleteProgram(renderer_id_);
     }
 
@@ -66,6 +87,13 @@ namespace moon
 
         std::string result;
 
+        packed_asset asset;
+        if (asset_archive::find(filepath, asset))
+        {
+            result.assign((const char*)asset.data, asset.size);
+            return result;
+        }
+
         // Fallback to filesystem loading
         std::ifstream in(std::filesystem::absolute(filepath), std::ios::in | std::ios::binary);
 
@@ -94,40 +122,89 @@ namespace moon
         return result;
     }
 
-    std::unordered_map<GLenum, std::string> opengl_shader::preprocess(const std::string& source)
+    bool opengl_shader::load_sources(std::unordered_map<GLenum, std::string>& out_sources)
     {
         MOON_PROFILE_FUNCTION();
 
-        std::unordered_map<GLenum, std::string> result;
+        const std::string source = read_file(filepath_);
+        if (source.empty())
+            return false;
 
-        const char* type_token = "#type";
-        size_t type_token_length = strlen(type_token);
-        size_t pos = source.find(type_token, 0);
-        while (pos != std::string::npos)
+        auto reader = [this](std::string_view path) { return read_file(path); };
+
+        out_sources.clear();
+        include_paths_.clear();
+        std::string expanded;
+        // stages are separate compilation units, each resolves its own includes
+        for (const auto& stage : shader_preprocessor::split_stages(source))
         {
-            size_t eol = source.find_first_of('\n', pos);
-            MOON_CORE_ASSERT(eol != std::string::npos, "Syntax error");
-            size_t begin = pos + type_token_length + 1;
-            std::string type = source.substr(begin, eol - begin);
-            MOON_CORE_ASSERT(shader_type_from_string(type), "Invalid shader type specified");
-
-            size_t next_line_begin = source.find_first_not_of('\n', eol);
-            pos = source.find(type_token, next_line_begin);
-            result[(GLenum)shader_type_from_string(type)] =
-                source.substr(next_line_begin, pos - (next_line_begin == std::string::npos ? source.size() - 1 : next_line_begin));
+            const GLenum type = shader_type_from_string(stage.type);
+            if (!type)
+            {
+                MOON_CORE_ERROR("Invalid shader type '{0}' in '{1}'", stage.type, filepath_);
+                return false;
+            }
+
+            if (!shader_preprocessor::resolve_includes(stage.code, filepath_, reader, expanded, include_paths_))
+                return false;
+            out_sources[type] = shader_preprocessor::add_defines(expanded, defines_);
         }
 
-        return result;
+        return !out_sources.empty();
+    }
+
+    static bool s_parallel_compile_checked = false;
+
+    /// Lets the driver compile on as many threads as it likes, the default may be a single one
+    static void init_parallel_compile()
+    {
+        s_parallel_compile_checked = true;
+
+        bool supported = false;
+        GLint extension_count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extension_count);
+        for (GLint i = 0; i < extension_count && !supported; i++)
+        {
+            const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+            supported = extension && (strcmp(extension, "GL_KHR_parallel_shader_compile") == 0 ||
+                                      strcmp(extension, "GL_ARB_parallel_shader_compile") == 0);
+        }
+
+        if (!supported)
+            return;
+
+        // glad isn't generated with the extension, so the entry point is looked up by hand
+        using max_threads_fn = void (*)(GLuint);
+        auto max_threads = (max_threads_fn)glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+        if (!max_threads)
+            max_threads = (max_threads_fn)glfwGetProcAddress("glMaxShaderCompilerThreadsARB");
+        if (max_threads)
+            max_threads(0xFFFFFFFF);
     }
 
-    void opengl_shader::compile(const std::unordered_map<GLenum, std::string>& shader_sources)
+    opengl_shader::pending_compile opengl_shader::start_compile(const std::unordered_map<GLenum, std::string>& shader_sources) const
     {
         MOON_PROFILE_FUNCTION();
 
-        GLuint program = glCreateProgram();
+        if (!s_parallel_compile_checked)
+            init_parallel_compile();
+
+        pending_compile pending;
+        pending.started_at = std::chrono::steady_clock::now();
+        pending.source_hash = opengl_program_cache::hash_sources(shader_sources);
+
+        if (GLuint cached = opengl_program_cache::load(pending.source_hash))
+        {
+            pending.program = cached;
+            pending.cached = true;
+            return pending;
+        }
+
+        // no status is queried here; the driver keeps working until finish_compile asks for the result
+        pending.program = glCreateProgram();
+        glProgramParameteri(pending.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
         MOON_CORE_ASSERT(shader_sources.size() <= 2, "Only 2 shaders are supported!");
-        std::array<GLuint, 2> gl_shader_ids {};
-        int gl_shader_id_index = 0;
+        uint32_t shader_index = 0;
 
         for (auto&& [type, source] : shader_sources)
         {
@@ -135,64 +212,285 @@ namespace moon
             const GLchar* source_cstr = source.data();
             glShaderSource(shader, 1, &source_cstr, nullptr);
             glCompileShader(shader);
+            glAttachShader(pending.program, shader);
 
-            GLint isCompiled = 0;
-            glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
-            if (isCompiled == GL_FALSE)
-            {
-                GLint maxLength = 0;
-                glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &maxLength);
-
-                std::vector<GLchar> infoLog(maxLength);
-                glGetShaderInfoLog(shader, maxLength, &maxLength, &infoLog[0]);
+            pending.shaders[shader_index++] = shader;
+        }
 
-                glDeleteShader(shader);
-                // delete previously compiled shaders
-                for (auto id : gl_shader_ids)
-                    glDeleteShader(id);
+        glLinkProgram(pending.program);
+        return pending;
+    }
 
-                MOON_CORE_ERROR("Compilation of shader type {0} failed: {1}", type, infoLog.data());
-                MOON_CORE_ASSERT(false, "Shader compilation failed!");
-                break;
-            }
+    GLuint opengl_shader::finish_compile(pending_compile& pending) const
+    {
+        MOON_PROFILE_FUNCTION();
 
-            glAttachShader(program, shader);
+        auto elapsed_ms = [&]() { return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - pending.started_at).count(); };
+        auto release = [&]()
+        {
+            for (auto id : pending.shaders)
+                glDeleteShader(id);
+            glDeleteProgram(pending.program);
+        };
 
-            gl_shader_ids[gl_shader_id_index++] = shader;
+        if (pending.cached)
+        {
+            MOON_CORE_INFO("Shader '{0}' loaded from the program cache in {1:.2f} ms", name_, elapsed_ms());
+            return pending.program;
         }
 
-        glLinkProgram(program);
+        GLuint program = pending.program;
 
+        // blocks until the driver is done with this program
         GLint isLinked = 0;
         glGetProgramiv(program, GL_LINK_STATUS, (int*)&isLinked);
         if (isLinked == GL_FALSE)
         {
+            // a stage that failed to compile is the more useful message
+            for (auto shader : pending.shaders)
+            {
+                GLint isCompiled = GL_TRUE;
+                if (shader)
+                    glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
+                if (isCompiled == GL_TRUE)
+                    continue;
+
+                GLint type = 0;
+                glGetShaderiv(shader, GL_SHADER_TYPE, &type);
+
+                GLint maxLength = 0;
+                glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &maxLength);
+
+                std::vector<GLchar> infoLog(std::max(maxLength, 1));
+                glGetShaderInfoLog(shader, maxLength, &maxLength, &infoLog[0]);
+
+                MOON_CORE_ERROR("Compilation of shader type {0} in '{1}' failed: {2}", type, name_, infoLog.data());
+                release();
+                return 0;
+            }
+
             GLint maxLength = 0;
             glGetProgramiv(program, GL_INFO_LOG_LENGTH, &maxLength);
 
-            std::vector<GLchar> infoLog(maxLength);
+            std::vector<GLchar> infoLog(std::max(maxLength, 1));
             glGetProgramInfoLog(program, maxLength, &maxLength, &infoLog[0]);
 
+            MOON_CORE_ERROR("Shader program '{0}' link failed: {1}", name_, infoLog.data());
+            release();
+            return 0;
+        }
+
+        for (auto id : pending.shaders)
+        {
+            if (!id)
+                continue;
+            glDetachShader(program, id);
+            glDeleteShader(id);
+        }
+
+        const float compile_ms = elapsed_ms();
+        MOON_CORE_INFO("Shader '{0}' compiled in {1:.2f} ms", name_, compile_ms);
+
+        // only validated programs reach the cache, so cached ones skip this
+        if (!validate_uniform_blocks(program))
+        {
             glDeleteProgram(program);
-            // delete all shaders
-            for (auto id : gl_shader_ids)
-                glDeleteShader(id);
+            return 0;
+        }
 
-            MOON_CORE_ERROR("Shader program link failed: {0}", infoLog.data());
-            MOON_CORE_ASSERT(false, "Shader program link failed!");
+        opengl_program_cache::store(pending.source_hash, program);
+        return program;
+    }
+
+    void opengl_shader::wait_until_linked() const
+    {
+        if (!pending_)
             return;
+
+        MOON_PROFILE_FUNCTION();
+
+        renderer_id_ = finish_compile(*pending_);
+        pending_.reset();
+        MOON_CORE_ASSERT(renderer_id_, "Shader compilation failed!");
+
+        cache_uniform_locations();
+    }
+
+    bool opengl_shader::validate_uniform_blocks(GLuint program) const
+    {
+        MOON_PROFILE_FUNCTION();
+
+        struct block_member
+        {
+            const char* name;
+            size_t offset;
+        };
+        static constexpr block_member camera_members[] = {
+            { "u_View",       offsetof(camera_uniforms, view) },
+            { "u_Projection", offsetof(camera_uniforms, projection) },
+            { "u_VP",         offsetof(camera_uniforms, view_projection) },
+            { "u_Viewport",   offsetof(camera_uniforms, viewport) },
+            { "u_Time",       offsetof(camera_uniforms, time) },
+        };
+
+        const GLuint block = glGetUniformBlockIndex(program, "Camera");
+        // shaders that don't need the camera don't declare it
+        if (block == GL_INVALID_INDEX)
+            return true;
+
+        GLint binding = -1;
+        glGetActiveUniformBlockiv(program, block, GL_UNIFORM_BLOCK_BINDING, &binding);
+        if (binding != (GLint)camera_uniforms::binding)
+        {
+            MOON_CORE_ERROR("Shader '{0}': Camera block must use binding {1}, not {2}", name_, camera_uniforms::binding, binding);
+            return false;
         }
 
-        for (auto id : gl_shader_ids)
-            glDetachShader(program, id);
+        // std140 keeps every member active, so each one must be found at the offset camera_uniforms has it
+        for (const auto& member : camera_members)
+        {
+            GLuint index = GL_INVALID_INDEX;
+            glGetUniformIndices(program, 1, &member.name, &index);
+            if (index == GL_INVALID_INDEX)
+            {
+                MOON_CORE_ERROR("Shader '{0}': Camera block has no member {1}", name_, member.name);
+                return false;
+            }
+
+            GLint offset = -1;
+            glGetActiveUniformsiv(program, 1, &index, GL_UNIFORM_OFFSET, &offset);
+            if (offset != (GLint)member.offset)
+            {
+                MOON_CORE_ERROR("Shader '{0}': Camera block member {1} is at offset {2}, expected {3}. Declare it std140",
+                    name_, member.name, offset, member.offset);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool opengl_shader::reload()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        if (filepath_.empty())
+            return false;
+
+        std::unordered_map<GLenum, std::string> shader_sources;
+        if (!load_sources(shader_sources))
+            return false;
+
+        wait_until_linked();
+
+        // a broken edit keeps the last working program bound
+        pending_compile pending = start_compile(shader_sources);
+        const GLuint program = finish_compile(pending);
+        if (!program)
+            return false;
 
+        copy_sampler_bindings(renderer_id_, program);
+        glDeleteProgram(renderer_id_);
         renderer_id_ = program;
+        cache_uniform_locations();
+        return true;
+    }
+
+    void opengl_shader::cache_uniform_locations() const
+    {
+        MOON_PROFILE_FUNCTION();
+
+        uniform_locations_.clear();
+
+        GLint uniform_count = 0;
+        glGetProgramiv(renderer_id_, GL_ACTIVE_UNIFORMS, &uniform_count);
+
+        for (GLint i = 0; i < uniform_count; i++)
+        {
+            GLchar name[256];
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(renderer_id_, (GLuint)i, sizeof(name), &length, &size, &type, name);
+
+            std::string base(name, length);
+            const GLint location = glGetUniformLocation(renderer_id_, base.c_str());
+            // members of uniform blocks have no location
+            if (location == -1)
+                continue;
+
+            if (!base.ends_with("[0]"))
+            {
+                uniform_locations_.emplace(std::move(base), location);
+                continue;
+            }
+
+            // arrays are set through their base name or a single element
+            base.resize(base.size() - 3);
+            uniform_locations_.emplace(base, location);
+            for (GLint element = 0; element < size; element++)
+            {
+                std::string element_name = base + "[" + std::to_string(element) + "]";
+                const GLint element_location = glGetUniformLocation(renderer_id_, element_name.c_str());
+                uniform_locations_.emplace(std::move(element_name), element_location);
+            }
+        }
+    }
+
+    GLint opengl_shader::get_uniform_location(std::string_view name)
+    {
+        wait_until_linked();
+
+        if (auto it = uniform_locations_.find(name); it != uniform_locations_.end())
+            return it->second;
+
+        // unknown or optimized out; remembered so the warning shows once and later sets stay a lookup
+        MOON_CORE_WARN("Shader '{0}' has no active uniform '{1}'", name_, name);
+        uniform_locations_.emplace(std::string(name), -1);
+        return -1;
+    }
+
+    void opengl_shader::copy_sampler_bindings(GLuint from, GLuint to)
+    {
+        GLint uniform_count = 0;
+        glGetProgramiv(from, GL_ACTIVE_UNIFORMS, &uniform_count);
+
+        for (GLint i = 0; i < uniform_count; i++)
+        {
+            GLchar name[256];
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(from, (GLuint)i, sizeof(name), &length, &size, &type, name);
+
+            if (type != GL_SAMPLER_2D && type != GL_SAMPLER_2D_ARRAY)
+                continue;
+
+            // arrays report their first element, e.g. u_Textures[0]
+            std::string base(name, length);
+            if (base.ends_with("[0]"))
+                base.resize(base.size() - 3);
+
+            for (GLint element = 0; element < size; element++)
+            {
+                const std::string element_name = size > 1 ? base + "[" + std::to_string(element) + "]" : base;
+                const GLint from_location = glGetUniformLocation(from, element_name.c_str());
+                const GLint to_location = glGetUniformLocation(to, element_name.c_str());
+                if (from_location == -1 || to_location == -1)
+                    continue;
+
+                GLint unit = 0;
+                glGetUniformiv(from, from_location, &unit);
+                glProgramUniform1i(to, to_location, unit);
+            }
+        }
     }
 
     void opengl_shader::bind() const
     {
         MOON_PROFILE_FUNCTION();
 
+        wait_until_linked();
         glUseProgram(renderer_id_);
     }
 
@@ -254,49 +552,49 @@ namespace moon
 
     void opengl_shader::upload_uniform_int(std::string_view name, int value)
     {
-        GLint location = glGetUniformLocation(renderer_id_, name.data());
+        GLint location = get_uniform_location(name);
         glUniform1i(location, value);
     }
 
     void opengl_shader::upload_uniform_int_array(std::string_view name, int* values, uint32_t count)
     {
-        GLint location = glGetUniformLocation(renderer_id_, name.data());
+        GLint location = get_uniform_location(name);
         glUniform1iv(location, count, values);
     }
 
     void opengl_shader::upload_uniform_float(std::string_view name, float value)
     {
-        GLint location = glGetUniformLocation(renderer_id_, name.data());
+        GLint location = get_uniform_location(name);
         glUniform1f(location, value);
     }
 
     void opengl_shader::upload_uniform_float2(std::string_view name, const glm::vec2& vector)
     {
-        GLint location = glGetUniformLocation(renderer_id_, name.data());
+        GLint location = get_uniform_location(name);
         glUniform2f(location, vector.x, vector.y);
     }
 
     void opengl_shader::upload_uniform_float3(std::string_view name, const glm::vec3& vector)
     {
-        GLint location = glGetUniformLocation(renderer_id_, name.data());
+        GLint location = get_uniform_location(name);
         glUniform3f(location, vector.x, vector.y, vector.z);
     }
 
     void opengl_shader::upload_uniform_float4(std::string_view name, const glm::vec4& vector)
     {
-        GLint location = glGetUniformLocation(renderer_id_, name.data());
+        GLint location = get_uniform_location(name);
         glUniform4f(location, vector.x, vector.y, vector.z, vector.w);
     }
 
     void opengl_shader::upload_uniform_mat3(std::string_view name, const glm::mat3& matrix)
     {
-        GLint location = glGetUniformLocation(renderer_id_, name.data());
+        GLint location = get_uniform_location(name);
         glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
     }
 
     void opengl_shader::upload_uniform_mat4(std::string_view name, const glm::mat4& matrix)
     {
-        GLint location = glGetUniformLocation(renderer_id_, name.data());
+        GLint location = get_uniform_location(name);
         glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
     }
 }
@@ -9,7 +9,13 @@
 #include "renderer/camera.h"
 #include "renderer/camera.h"
 
+#include <array>
+#include <chrono>
+#include <optional>
+#include <string>
 #include <string_view>
+#include <unordered_map>
+#include <vector>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
@@ -19,7 +25,8 @@ namespace moon
     class MOON_API opengl_shader : public shader
     {
     public:
-        explicit opengl_shader(std::string_view filepath);
+        /// defines select a permutation, each becomes a #define after #version
+        explicit opengl_shader(std::string_view filepath, std::vector<std::string> defines = {});
         opengl_shader(std::string_view name, std::string_view vertex_src, std::string_view fragment_src);
         ~opengl_shader() override;
 
@@ -35,6 +42,8 @@ namespace moon
         void set_mat4(::std::string_view name, const glm::mat4& value) override;
 
         std::string_view get_name() override { return name_; }
+        bool reload() override;
+        [[nodiscard]] const std::vector<std::string>& get_include_paths() const override { return include_paths_; }
 
         void upload_uniform_int(std::string_view name, int value);
         void upload_uniform_int_array(std::string_view name, int* values, uint32_t count);
@@ -47,10 +56,47 @@ namespace moon
 
     private:
         std::string read_file(std::string_view filepath);
-        std::unordered_map<GLenum, std::string> preprocess(const std::string& source);
-        void compile(const std::unordered_map<GLenum, std::string>& shader_sources);
+        /// Reads filepath_ and runs it through shader_preprocessor with defines_, one source per stage
+        bool load_sources(std::unordered_map<GLenum, std::string>& out_sources);
+        struct pending_compile
+        {
+            GLuint program = 0;
+            std::array<GLuint, 2> shaders {};
+            uint64_t source_hash = 0;
+            // loaded from the program cache, already linked
+            bool cached = false;
+            std::chrono::steady_clock::time_point started_at;
+        };
+
+        /// Issues the compile and link without waiting for either
+        pending_compile start_compile(const std::unordered_map<GLenum, std::string>& shader_sources) const;
+        /// Waits for the driver, returns the linked program or 0 if compiling or linking failed
+        GLuint finish_compile(pending_compile& pending) const;
+        /// Finishes the initial compile on first use
+        void wait_until_linked() const;
+        /// Sampler units are set once at init, a reloaded program has to inherit them
+        static void copy_sampler_bindings(GLuint from, GLuint to);
+        /// Checks the blocks the engine fills, currently the camera block, against their c++ layout
+        bool validate_uniform_blocks(GLuint program) const;
+        /// Resolves every active uniform once after linking, array elements included
+        void cache_uniform_locations() const;
+        [[nodiscard]] GLint get_uniform_location(std::string_view name);
     private:
-        uint32_t renderer_id_{0};
+        // lets the location map be searched with a string_view without building a string
+        struct string_hash
+        {
+            using is_transparent = void;
+            size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+        };
+
+        // bind() is const but may be what completes the initial compile
+        mutable uint32_t renderer_id_{0};
+        mutable std::optional<pending_compile> pending_;
         std::string name_;
+        // empty for shaders built from source strings
+        std::string filepath_;
+        std::vector<std::string> defines_;
+        std::vector<std::string> include_paths_;
+        mutable std::unordered_map<std::string, GLint, string_hash, std::equal_to<>> uniform_locations_;
     };
 }
@@ -6,95 +6,518 @@
 
 #include <glad/glad.h>
 
+#include "moon/core/mapped_file.h"
+#include "moon/asset/asset_archive.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
 namespace moon
 {
-    opengl_texture2d::opengl_texture2d(uint32_t width, uint32_t height)
+    // GL_EXT_texture_compression_s3tc isn't part of core, so the loader may not define its enums
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+    #define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+    #define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+    static GLenum to_gl_internal_format(texture_format format)
+    {
+        switch (format)
+        {
+        case texture_format::RGB8:  return GL_RGB8;
+        case texture_format::RGBA8: return GL_RGBA8;
+        case texture_format::R8:    return GL_R8;
+        case texture_format::BC1:   return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case texture_format::BC3:   return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case texture_format::BC7:   return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        }
+
+        MOON_CORE_ASSERT(false, "Unknown texture format!");
+        return GL_RGBA8;
+    }
+
+    static GLenum to_gl_data_format(texture_format format)
+    {
+        switch (format)
+        {
+        case texture_format::RGB8: return GL_RGB;
+        case texture_format::R8:   return GL_RED;
+        default:                   return GL_RGBA;
+        }
+    }
+
+    static uint32_t get_bytes_per_pixel(GLenum data_format)
+    {
+        switch (data_format)
+        {
+        case GL_RGB: return 3;
+        case GL_RED: return 1;
+        default:     return 4;
+        }
+    }
+
+    static GLint to_gl_filter(texture_filter filter, bool mipmapped)
+    {
+        if (filter == texture_filter::nearest)
+            return mipmapped ? GL_NEAREST_MIPMAP_NEAREST : GL_NEAREST;
+        return mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR;
+    }
+
+    static GLint to_gl_wrap(texture_wrap wrap)
+    {
+        switch (wrap)
+        {
+        case texture_wrap::repeat:          return GL_REPEAT;
+        case texture_wrap::clamp_to_edge:   return GL_CLAMP_TO_EDGE;
+        case texture_wrap::mirrored_repeat: return GL_MIRRORED_REPEAT;
+        }
+
+        MOON_CORE_ASSERT(false, "Unknown texture wrap mode!");
+        return GL_REPEAT;
+    }
+
+    static uint32_t get_full_mip_count(uint32_t width, uint32_t height)
+    {
+        return (uint32_t)std::bit_width(std::max(width, height));
+    }
+
+    /// Bytes per 4x4 block, 0 for uncompressed formats
+    static uint32_t get_block_size(texture_format format)
+    {
+        switch (format)
+        {
+        case texture_format::BC1: return 8;
+        case texture_format::BC3:
+        case texture_format::BC7: return 16;
+        default:                  return 0;
+        }
+    }
+
+    static uint64_t get_level_size(texture_format format, uint32_t width, uint32_t height)
+    {
+        if (const uint32_t block_size = get_block_size(format))
+            return (uint64_t)((width + 3) / 4) * ((height + 3) / 4) * block_size;
+
+        if (format == texture_format::R8)
+            return (uint64_t)width * height;
+
+        // drivers pad rgb8 texels to 4 bytes
+        return (uint64_t)width * height * 4;
+    }
+
+    static uint64_t get_chain_size(texture_format format, uint32_t width, uint32_t height, uint32_t levels)
+    {
+        uint64_t size = 0;
+        for (uint32_t level = 0; level < levels; level++)
+            size += get_level_size(format, std::max(1u, width >> level), std::max(1u, height >> level));
+        return size;
+    }
+
+    opengl_texture2d::opengl_texture2d(uint32_t width, uint32_t height, const texture_spec& spec)
         :
-        width_(width), height_(height)
+        spec_(spec), width_(width), height_(height), renderer_id_(0)
     {
         MOON_PROFILE_FUNCTION();
 
-        internal_format_ = GL_RGBA8;
-        data_format_ = GL_RGBA;
+        MOON_CORE_ASSERT(spec_.format == texture_format::RGBA8 || spec_.format == texture_format::RGB8 || spec_.format == texture_format::R8,
+            "Compressed textures can only be loaded from .dds files!");
 
-        glCreateTextures(GL_TEXTURE_2D, 1, &renderer_id_);
-        glTextureStorage2D(renderer_id_, 1, internal_format_, width_, height_);
+        internal_format_ = to_gl_internal_format(spec_.format);
+        data_format_ = to_gl_data_format(spec_.format);
 
-        glTextureParameteri(renderer_id_, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTextureParameteri(renderer_id_, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        create_storage(spec_.generate_mips ? get_full_mip_count(width_, height_) : 1);
+    }
 
-        glTextureParameteri(renderer_id_, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTextureParameteri(renderer_id_, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    opengl_texture2d::opengl_texture2d(std::string_view path, const texture_spec& spec)
+        :
+        path_(path), spec_(spec), width_(0), height_(0), renderer_id_(0)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        const bool loaded = load_from_file();
+        MOON_CORE_ASSERT(loaded, "Failed to load image!");
     }
 
-    opengl_texture2d::opengl_texture2d(std::string_view path)
+    opengl_texture2d::opengl_texture2d(std::string_view path, const ref<texture2d>& placeholder, const texture_spec& spec)
         :
-        path_(path.data())
+        path_(path), spec_(spec),
+        width_(placeholder->get_width()), height_(placeholder->get_height()),
+        renderer_id_(placeholder->get_renderer_id()),
+        internal_format_(GL_RGBA8), data_format_(GL_RGBA),
+        placeholder_(placeholder)
+    {}
+
+    opengl_texture2d::~opengl_texture2d()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        if (!placeholder_)
+            glDeleteTextures(1, &renderer_id_);
+    }
+
+    void opengl_texture2d::set_data(void* data, uint32_t size)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        MOON_CORE_ASSERT(!is_compressed(), "Compressed textures can't be written to!");
+        uint32_t bpp = get_bytes_per_pixel(data_format_);
+        MOON_CORE_ASSERT(size == width_ * height_ * bpp, "Data must be entire texture!");
+        glTextureSubImage2D(renderer_id_, 0, 0, 0, width_, height_, data_format_, GL_UNSIGNED_BYTE, data);
+
+        if (mip_levels_ > 1)
+            glGenerateTextureMipmap(renderer_id_);
+    }
+
+    void opengl_texture2d::set_region_data(const void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        MOON_CORE_ASSERT(!is_compressed(), "Compressed textures can't be written to!");
+        MOON_CORE_ASSERT(x + width <= width_ && y + height <= height_, "Region must lie within the texture!");
+        glPixelStorei(GL_UNPACK_ALIGNMENT, data_format_ == GL_RGBA ? 4 : 1);
+        glTextureSubImage2D(renderer_id_, 0, (GLint)x, (GLint)y, (GLsizei)width, (GLsizei)height, data_format_, GL_UNSIGNED_BYTE, data);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        if (mip_levels_ > 1)
+            glGenerateTextureMipmap(renderer_id_);
+    }
+
+    void opengl_texture2d::upload_image(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels)
     {
         MOON_PROFILE_FUNCTION();
 
+        MOON_CORE_ASSERT(channels == 3 || channels == 4, "Format not supported!");
+
+        if (spec_.format != texture_format::RGBA8 && spec_.format != texture_format::RGB8 && spec_.format != texture_format::R8)
+            MOON_CORE_WARN("'{0}' isn't block compressed, it is uploaded uncompressed. Cook it to .dds to save memory", path_);
+
+        spec_.format = channels == 4 ? texture_format::RGBA8 : texture_format::RGB8;
+        width_ = width;
+        height_ = height;
+        internal_format_ = channels == 4 ? GL_RGBA8 : GL_RGB8;
+        data_format_ = channels == 4 ? GL_RGBA : GL_RGB;
+
+        create_storage(spec_.generate_mips ? get_full_mip_count(width_, height_) : 1);
+
+        // rgb rows aren't 4 byte aligned for every width
+        glPixelStorei(GL_UNPACK_ALIGNMENT, channels == 4 ? 4 : 1);
+        glTextureSubImage2D(renderer_id_, 0, 0, 0, width_, height_, data_format_, GL_UNSIGNED_BYTE, pixels);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        if (mip_levels_ > 1)
+            glGenerateTextureMipmap(renderer_id_);
+    }
+
+    bool opengl_texture2d::load_from_file()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        // cooked builds have the image decoded already
+        packed_asset asset;
+        if (asset_archive::find(path_, asset))
+        {
+            if (asset.type == asset_type::texture)
+            {
+                upload_image(asset.data, asset.width, asset.height, asset.channels);
+                return true;
+            }
+            if (path_.ends_with(".dds"))
+                return load_dds(asset.data, asset.size, path_);
+        }
+
+        if (path_.ends_with(".dds"))
+        {
+            mapped_file file;
+            return file.open(path_) && load_dds(file.data(), file.size(), path_);
+        }
+
         stbi_set_flip_vertically_on_load(true);
         int width, height, channels;
         stbi_uc* data = nullptr;
 
         {
-            MOON_PROFILE_SCOPE("stbi_load - opengl_texture2d::opengl_texture2d(std::string_view path)");
+            MOON_PROFILE_SCOPE("stbi_load - opengl_texture2d::load_from_file");
+
+            // grey and grey-alpha images are expanded, we only upload rgb and rgba
+            int desired_channels = 0;
+            if (stbi_info(path_.c_str(), &width, &height, &channels) && channels != 3)
+                desired_channels = 4;
 
-            data = stbi_load(path.data(), &width, &height, &channels, 0);
+            data = stbi_load(path_.c_str(), &width, &height, &channels, desired_channels);
+            if (desired_channels)
+                channels = desired_channels;
+        }
+        if (!data)
+        {
+            MOON_CORE_ERROR("Failed to load image '{0}': {1}", path_, stbi_failure_reason());
+            return false;
         }
-        MOON_CORE_ASSERT(data, "Failed to load image!");
 
-        width_ = width;
-        height_ = height;
+        upload_image(data, (uint32_t)width, (uint32_t)height, (uint32_t)channels);
 
-        GLenum internal_format = 0, data_format = 0;
-        if (channels == 4)
+        stbi_image_free(data);
+        return true;
+    }
+
+    bool opengl_texture2d::reload()
+    {
+        MOON_PROFILE_FUNCTION();
+
+        if (path_.empty())
+            return false;
+
+        // a failed load leaves the previous image in place
+        return load_from_file();
+    }
+
+    void opengl_texture2d::bind(uint32_t slot) const
+    {
+        MOON_PROFILE_FUNCTION();
+
+        glBindTextureUnit(slot, renderer_id_);
+    }
+
+    void opengl_texture2d::create_storage(uint32_t mip_levels)
+    {
+        if (placeholder_)
+            placeholder_.reset();
+        else if (renderer_id_)
+            glDeleteTextures(1, &renderer_id_);
+
+        mip_levels_ = mip_levels;
+
+        glCreateTextures(GL_TEXTURE_2D, 1, &renderer_id_);
+        glTextureStorage2D(renderer_id_, (GLsizei)mip_levels_, internal_format_, width_, height_);
+
+        glTextureParameteri(renderer_id_, GL_TEXTURE_MIN_FILTER, to_gl_filter(spec_.min_filter, mip_levels_ > 1));
+        glTextureParameteri(renderer_id_, GL_TEXTURE_MAG_FILTER, to_gl_filter(spec_.mag_filter, false));
+        glTextureParameteri(renderer_id_, GL_TEXTURE_MAX_LEVEL, (GLint)mip_levels_ - 1);
+
+        glTextureParameteri(renderer_id_, GL_TEXTURE_WRAP_S, to_gl_wrap(spec_.wrap));
+        glTextureParameteri(renderer_id_, GL_TEXTURE_WRAP_T, to_gl_wrap(spec_.wrap));
+
+        if (internal_format_ == GL_R8)
+        {
+            // shaders written for rgba images see the single channel as coverage
+            const GLint swizzle[4] = { GL_ONE, GL_ONE, GL_ONE, GL_RED };
+            glTextureParameteriv(renderer_id_, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+        }
+
+        texture_format format = spec_.format;
+        if (!is_compressed())
+            format = internal_format_ == GL_RGBA8 ? texture_format::RGBA8 : internal_format_ == GL_R8 ? texture_format::R8 : texture_format::RGB8;
+        memory_size_ = get_chain_size(format, width_, height_, mip_levels_);
+    }
+
+    bool opengl_texture2d::is_compressed() const
+    {
+        return internal_format_ != GL_RGBA8 && internal_format_ != GL_RGB8 && internal_format_ != GL_R8;
+    }
+
+    // ////////////////////////////////////////////////
+    // DDS ////////////////////////////////////////////
+
+    static constexpr uint32_t s_dds_magic = 0x20534444; // "DDS "
+    static constexpr uint32_t s_fourcc_dxt1 = 0x31545844; // "DXT1"
+    static constexpr uint32_t s_fourcc_dxt5 = 0x35545844; // "DXT5"
+    static constexpr uint32_t s_fourcc_dx10 = 0x30315844; // "DX10"
+    static constexpr uint32_t s_dds_pixel_format_fourcc = 0x4;
+
+    struct dds_pixel_format
+    {
+        uint32_t size, flags, four_cc, rgb_bit_count, r_mask, g_mask, b_mask, a_mask;
+    };
+
+    struct dds_header
+    {
+        uint32_t size, flags, height, width, pitch_or_linear_size, depth, mip_map_count;
+        uint32_t reserved1[11];
+        dds_pixel_format pixel_format;
+        uint32_t caps, caps2, caps3, caps4, reserved2;
+    };
+
+    struct dds_header_dx10
+    {
+        uint32_t dxgi_format, resource_dimension, misc_flag, array_size, misc_flags2;
+    };
+
+    static_assert(sizeof(dds_header) == 124);
+
+    bool opengl_texture2d::load_dds(const uint8_t* data, size_t size, std::string_view path)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        uint32_t magic;
+        dds_header header;
+        if (size < sizeof(magic) + sizeof(header))
         {
-            internal_format = GL_RGBA8;
-            data_format = GL_RGBA;
+            MOON_CORE_ERROR("'{0}' is too small to be a dds file", path);
+            return false;
         }
-        else if (channels == 3)
+        std::memcpy(&magic, data, sizeof(magic));
+        std::memcpy(&header, data + sizeof(magic), sizeof(header));
+        size_t offset = sizeof(magic) + sizeof(header);
+
+        if (magic != s_dds_magic || header.size != sizeof(dds_header) || !(header.pixel_format.flags & s_dds_pixel_format_fourcc))
         {
-            internal_format = GL_RGB8;
-            data_format = GL_RGB;
+            MOON_CORE_ERROR("'{0}' isn't a block compressed dds file", path);
+            return false;
         }
 
-        internal_format = internal_format ? internal_format : GL_RGBA;
-        data_format = data_format ? data_format : GL_RGBA;
+        texture_format format;
+        switch (header.pixel_format.four_cc)
+        {
+        case s_fourcc_dxt1: format = texture_format::BC1; break;
+        case s_fourcc_dxt5: format = texture_format::BC3; break;
+        case s_fourcc_dx10:
+        {
+            dds_header_dx10 dx10;
+            if (size < offset + sizeof(dx10))
+            {
+                MOON_CORE_ERROR("'{0}' is truncated", path);
+                return false;
+            }
+            std::memcpy(&dx10, data + offset, sizeof(dx10));
+            offset += sizeof(dx10);
 
-        MOON_CORE_ASSERT(internal_format & data_format, "Format not supported!");
+            // DXGI_FORMAT_BC1_UNORM(_SRGB), BC3_UNORM(_SRGB), BC7_UNORM(_SRGB)
+            if (dx10.dxgi_format == 71 || dx10.dxgi_format == 72)
+                format = texture_format::BC1;
+            else if (dx10.dxgi_format == 77 || dx10.dxgi_format == 78)
+                format = texture_format::BC3;
+            else if (dx10.dxgi_format == 98 || dx10.dxgi_format == 99)
+                format = texture_format::BC7;
+            else
+            {
+                MOON_CORE_ERROR("'{0}' uses unsupported dxgi format {1}", path, dx10.dxgi_format);
+                return false;
+            }
+        } break;
+        default:
+            MOON_CORE_ERROR("'{0}' uses an unsupported block format", path);
+            return false;
+        }
 
-        glCreateTextures(GL_TEXTURE_2D, 1, &renderer_id_);
-        glTextureStorage2D(renderer_id_, 1, internal_format, width_, height_);
+        // validated before touching any member, so a failed reload keeps the previous image
+        const uint32_t width = header.width;
+        const uint32_t height = header.height;
+        if (width == 0 || height == 0)
+        {
+            MOON_CORE_ERROR("'{0}' has no pixels", path);
+            return false;
+        }
+
+        const uint32_t levels = std::max(1u, header.mip_map_count);
+        if (levels > get_full_mip_count(width, height))
+        {
+            MOON_CORE_ERROR("'{0}' claims {1} mips, a {2}x{3} image has at most {4}", path, levels, width, height,
+                get_full_mip_count(width, height));
+            return false;
+        }
+
+        if (size - offset < get_chain_size(format, width, height, levels))
+        {
+            MOON_CORE_ERROR("'{0}' is truncated", path);
+            return false;
+        }
+
+        if (levels == 1 && spec_.generate_mips)
+            MOON_CORE_WARN("'{0}' has no mips, compressed textures can't generate them at runtime", path);
+
+        spec_.format = format;
+        width_ = width;
+        height_ = height;
+        internal_format_ = to_gl_internal_format(format);
+        data_format_ = GL_RGBA;
+
+        create_storage(levels);
+
+        // cook dds files flipped vertically, blocks can't be flipped on upload like stb does for other images
+        for (uint32_t level = 0; level < levels; level++)
+        {
+            const uint32_t level_width = std::max(1u, width_ >> level);
+            const uint32_t level_height = std::max(1u, height_ >> level);
+            const uint64_t level_size = get_level_size(format, level_width, level_height);
+
+            glCompressedTextureSubImage2D(renderer_id_, (GLint)level, 0, 0, (GLsizei)level_width, (GLsizei)level_height,
+                internal_format_, (GLsizei)level_size, data + offset);
+            offset += level_size;
+        }
+
+        return true;
+    }
+
+    opengl_texture2d_array::opengl_texture2d_array(uint32_t width, uint32_t height, uint32_t layer_count)
+        :
+        width_(width), height_(height), layer_count_(layer_count)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &renderer_id_);
+        glTextureStorage3D(renderer_id_, 1, GL_RGBA8, width_, height_, layer_count_);
 
         glTextureParameteri(renderer_id_, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTextureParameteri(renderer_id_, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
         glTextureParameteri(renderer_id_, GL_TEXTURE_WRAP_S, GL_REPEAT);
         glTextureParameteri(renderer_id_, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    }
 
-        glTextureSubImage2D(renderer_id_, 0, 0, 0, width_, height_, data_format, GL_UNSIGNED_BYTE, data);
+    opengl_texture2d_array::~opengl_texture2d_array()
+    {
+        MOON_PROFILE_FUNCTION();
 
-        stbi_image_free(data);
+        glDeleteTextures(1, &renderer_id_);
     }
 
-    opengl_texture2d::~opengl_texture2d()
+    void opengl_texture2d_array::set_data(void* data, uint32_t size)
     {
         MOON_PROFILE_FUNCTION();
 
-        glDeleteTextures(1, &renderer_id_);
+        MOON_CORE_ASSERT(size == width_ * height_ * 4 * layer_count_, "Data must be entire texture!");
+        glTextureSubImage3D(renderer_id_, 0, 0, 0, 0, width_, height_, layer_count_, GL_RGBA, GL_UNSIGNED_BYTE, data);
     }
 
-    void opengl_texture2d::set_data(void* data, uint32_t size)
+    void opengl_texture2d_array::set_layer_data(uint32_t layer, const void* data, uint32_t size)
     {
         MOON_PROFILE_FUNCTION();
 
-        uint32_t bpp = data_format_ == GL_RGBA ? 4 : 3;
-        MOON_CORE_ASSERT(size == width_ * height_ * bpp, "Data must be entire texture!");
-        glTextureSubImage2D(renderer_id_, 0, 0, 0, width_, height_, data_format_, GL_UNSIGNED_BYTE, data);
+        MOON_CORE_ASSERT(layer < layer_count_, "Layer out of range!");
+        MOON_CORE_ASSERT(size == width_ * height_ * 4, "Data must be an entire layer!");
+        glTextureSubImage3D(renderer_id_, 0, 0, 0, (GLint)layer, width_, height_, 1, GL_RGBA, GL_UNSIGNED_BYTE, data);
     }
 
-    void opengl_texture2d::bind(uint32_t slot) const
+    bool opengl_texture2d_array::load_layer(uint32_t layer, std::string_view path)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        const std::string path_string(path);
+
+        stbi_set_flip_vertically_on_load(true);
+        int width, height, channels;
+        stbi_uc* data = stbi_load(path_string.c_str(), &width, &height, &channels, 4);
+        if (!data)
+        {
+            MOON_CORE_ERROR("Failed to load image '{0}': {1}", path, stbi_failure_reason());
+            return false;
+        }
+
+        if ((uint32_t)width != width_ || (uint32_t)height != height_)
+        {
+            MOON_CORE_ERROR("'{0}' is {1}x{2}, the texture array holds {3}x{4} images", path, width, height, width_, height_);
+            stbi_image_free(data);
+            return false;
+        }
+
+        set_layer_data(layer, data, width_ * height_ * 4);
+        stbi_image_free(data);
+        return true;
+    }
+
+    void opengl_texture2d_array::bind(uint32_t slot) const
     {
         MOON_PROFILE_FUNCTION();
 
@@ -9,15 +9,24 @@ namespace moon
     class opengl_texture2d : public texture2d
     {
     public:
-        opengl_texture2d(uint32_t width, uint32_t height);
-        explicit opengl_texture2d(std::string_view path);
+        opengl_texture2d(uint32_t width, uint32_t height, const texture_spec& spec = {});
+        explicit opengl_texture2d(std::string_view path, const texture_spec& spec = {});
+        /// Shares the placeholder's gl texture until upload_image is called; path is only remembered for reload
+        opengl_texture2d(std::string_view path, const ref<texture2d>& placeholder, const texture_spec& spec = {});
         ~opengl_texture2d() override;
 
         uint32_t get_width() const override { return width_; }
         uint32_t get_height() const override { return height_; }
         uint32_t get_renderer_id() const override { return renderer_id_; }
+        // the placeholder's memory isn't ours
+        uint64_t get_memory_size() const override { return placeholder_ ? 0 : memory_size_; }
 
         void set_data(void* data, uint32_t size) override;
+        void set_region_data(const void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+        void upload_image(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels) override;
+        [[nodiscard]] bool is_loaded() const override { return !placeholder_; }
+        bool reload() override;
+        [[nodiscard]] const texture_spec& get_spec() const override { return spec_; }
 
         void bind(uint32_t slot = 0) const override;
 
@@ -26,11 +35,53 @@ namespace moon
             return renderer_id_ == ((opengl_texture2d&)other).renderer_id_;
         }
 
+    private:
+        /// Replaces the gl texture with fresh storage in internal_format_ and applies the spec's sampling state
+        void create_storage(uint32_t mip_levels);
+        /// Loads path_ from the mounted archives or the disk, false leaves the current image untouched
+        bool load_from_file();
+        bool load_dds(const uint8_t* data, size_t size, std::string_view path);
+        [[nodiscard]] bool is_compressed() const;
+
     private:
         std::string path_;
+        texture_spec spec_;
         uint32_t width_, height_;
         uint32_t renderer_id_;
+        uint32_t mip_levels_ = 1;
+        uint64_t memory_size_ = 0;
 
         GLenum internal_format_, data_format_;
+
+        // held until upload_image, renderer_id_ belongs to it meanwhile
+        ref<texture2d> placeholder_;
+    };
+
+    class opengl_texture2d_array : public texture2d_array
+    {
+    public:
+        opengl_texture2d_array(uint32_t width, uint32_t height, uint32_t layer_count);
+        ~opengl_texture2d_array() override;
+
+        uint32_t get_width() const override { return width_; }
+        uint32_t get_height() const override { return height_; }
+        uint32_t get_renderer_id() const override { return renderer_id_; }
+        uint64_t get_memory_size() const override { return (uint64_t)width_ * height_ * 4 * layer_count_; }
+        uint32_t get_layer_count() const override { return layer_count_; }
+
+        void set_data(void* data, uint32_t size) override;
+        void set_layer_data(uint32_t layer, const void* data, uint32_t size) override;
+        bool load_layer(uint32_t layer, std::string_view path) override;
+
+        void bind(uint32_t slot = 0) const override;
+
+        bool operator==(const texture& other) const override
+        {
+            return renderer_id_ == other.get_renderer_id();
+        }
+
+    private:
+        uint32_t width_, height_, layer_count_;
+        uint32_t renderer_id_;
     };
 }
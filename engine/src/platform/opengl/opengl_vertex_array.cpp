@@ -21,6 +21,7 @@ namespace moon
         case ShaderDataType::Int3:      return GL_INT;
         case ShaderDataType::Int4:      return GL_INT;
         case ShaderDataType::Bool:      return GL_BOOL;
+        case ShaderDataType::UByte4:    return GL_UNSIGNED_BYTE;
         default: MOON_CORE_ASSERT(false, "Unknown ShaderDataType!"); return 0;
         }
     }
@@ -57,11 +58,23 @@ namespace moon
     {
         MOON_PROFILE_FUNCTION();
 
+        add_buffer(vbuf, 0);
+    }
+
+    void opengl_vertex_array::add_instance_buffer(ref<vertex_buffer> vbuf)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        add_buffer(vbuf, 1);
+    }
+
+    void opengl_vertex_array::add_buffer(const ref<vertex_buffer>& vbuf, uint32_t divisor)
+    {
         MOON_CORE_ASSERT(!vbuf->get_layout().get_elements().empty(), "Vertex Buffer has no layout!");
         glBindVertexArray(renderer_id_);
         vbuf->bind();
 
-        uint32_t buffer_index = 0;
+        uint32_t& buffer_index = attribute_count_;
         const auto& layout = vbuf->get_layout();
         for (const auto& element : layout)
         {
@@ -74,6 +87,7 @@ namespace moon
             );
 
             glEnableVertexAttribArray(buffer_index);
+            glVertexAttribDivisor(buffer_index, divisor);
             buffer_index++;
         }
 
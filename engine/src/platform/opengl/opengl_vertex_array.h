@@ -14,13 +14,19 @@ namespace moon
         void unbind() const override;
 
         void add_vertex_buffer(ref<vertex_buffer> vbuf) override;
+        void add_instance_buffer(ref<vertex_buffer> vbuf) override;
         void set_index_buffer(ref<index_buffer> ibuf) override;
 
         const std::vector<ref<vertex_buffer>>& get_vertex_buffers() const override { return vertex_buffers_; }
         const ref<index_buffer>& get_index_buffer() const override { return index_buffer_; }
+    private:
+        void add_buffer(const ref<vertex_buffer>& vbuf, uint32_t divisor);
+
     private:
         std::vector<ref<vertex_buffer>> vertex_buffers_;
         ref<index_buffer> index_buffer_;
         uint32_t renderer_id_{0};
+        // attributes of later buffers follow those of earlier ones
+        uint32_t attribute_count_{0};
     };
 }
@@ -0,0 +1,83 @@
+#include "moonpch.h"
+
+#include "moon/core/file_watcher.h"
+
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+namespace moon
+{
+    // polls modification times; asset directories are small enough that a scan per wait is cheap
+    struct file_watcher::impl
+    {
+        using file_times = std::unordered_map<std::string, std::filesystem::file_time_type>;
+
+        std::mutex mutex;
+        std::unordered_map<std::string, file_times> directories;
+
+        static file_times scan(const std::string& directory)
+        {
+            file_times times;
+            std::error_code ec;
+            for (const auto& entry : std::filesystem::directory_iterator(directory, ec))
+            {
+                if (entry.is_regular_file(ec))
+                    times[entry.path().filename().string()] = entry.last_write_time(ec);
+            }
+            return times;
+        }
+    };
+
+    file_watcher::file_watcher()
+        :
+        impl_(create_scope<impl>())
+    {}
+
+    file_watcher::~file_watcher() = default;
+
+    bool file_watcher::add_directory(std::string_view directory)
+    {
+        const std::string directory_str(directory);
+        if (!std::filesystem::is_directory(directory_str))
+        {
+            MOON_CORE_ERROR("Failed to watch directory: {0}", directory);
+            return false;
+        }
+
+        auto times = impl::scan(directory_str);
+
+        std::lock_guard lock(impl_->mutex);
+        impl_->directories.try_emplace(directory_str, std::move(times));
+        return true;
+    }
+
+    void file_watcher::wait(std::vector<std::string>& out_changed, uint32_t timeout_ms)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+
+        std::vector<std::string> directories;
+        {
+            std::lock_guard lock(impl_->mutex);
+            for (const auto& [directory, times] : impl_->directories)
+                directories.push_back(directory);
+        }
+
+        // scan without holding the lock, so add_directory doesn't wait on the disk
+        for (const auto& directory : directories)
+        {
+            auto times = impl::scan(directory);
+
+            std::lock_guard lock(impl_->mutex);
+            auto& known = impl_->directories[directory];
+            for (const auto& [name, time] : times)
+            {
+                auto it = known.find(name);
+                if (it == known.end() || it->second != time)
+                    out_changed.push_back(directory + "/" + name);
+            }
+            known = std::move(times);
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#include "moonpch.h"
+
+#include "moon/core/mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace moon
+{
+    bool mapped_file::open(std::string_view path)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        close();
+
+        const std::string path_str(path);
+        int fd = ::open(path_str.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            MOON_CORE_ERROR("Failed to open file for mapping: {0}", path);
+            return false;
+        }
+
+        struct stat st {};
+        if (fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            MOON_CORE_ERROR("Cannot map empty or unreadable file: {0}", path);
+            ::close(fd);
+            return false;
+        }
+
+        void* mapping = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // the mapping keeps its own reference to the file
+        ::close(fd);
+
+        if (mapping == MAP_FAILED)
+        {
+            MOON_CORE_ERROR("mmap failed for file: {0}", path);
+            return false;
+        }
+
+        data_ = (const uint8_t*)mapping;
+        size_ = (size_t)st.st_size;
+        return true;
+    }
+
+    void mapped_file::close()
+    {
+        if (data_)
+        {
+            munmap((void*)data_, size_);
+            data_ = nullptr;
+            size_ = 0;
+        }
+    }
+
+    void mapped_file::prefetch() const
+    {
+        if (data_)
+            madvise((void*)data_, size_, MADV_WILLNEED);
+    }
+}
@@ -0,0 +1,70 @@
+#include "moonpch.h"
+
+#include "moon/core/mapped_file.h"
+
+namespace moon
+{
+    bool mapped_file::open(std::string_view path)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        close();
+
+        const std::string path_str(path);
+        HANDLE file = CreateFileA(path_str.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            MOON_CORE_ERROR("Failed to open file for mapping: {0}", path);
+            return false;
+        }
+
+        LARGE_INTEGER file_size {};
+        if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+        {
+            MOON_CORE_ERROR("Cannot map empty or unreadable file: {0}", path);
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        // the view keeps the file and the mapping object alive
+        CloseHandle(file);
+        if (!mapping)
+        {
+            MOON_CORE_ERROR("CreateFileMapping failed for file: {0}", path);
+            return false;
+        }
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (!view)
+        {
+            MOON_CORE_ERROR("MapViewOfFile failed for file: {0}", path);
+            return false;
+        }
+
+        data_ = (const uint8_t*)view;
+        size_ = (size_t)file_size.QuadPart;
+        return true;
+    }
+
+    void mapped_file::close()
+    {
+        if (data_)
+        {
+            UnmapViewOfFile(data_);
+            data_ = nullptr;
+            size_ = 0;
+        }
+    }
+
+    void mapped_file::prefetch() const
+    {
+        // touch one byte per page; PrefetchVirtualMemory isn't available on every toolchain we support
+        constexpr size_t page_size = 4096;
+        volatile uint8_t sink = 0;
+        for (size_t offset = 0; offset < size_; offset += page_size)
+            sink = (uint8_t)(sink + data_[offset]);
+    }
+}
@@ -6,6 +6,7 @@
 #include "moon/events/application_event.h"
 #include "moon/events/mouse_event.h"
 #include "moon/events/key_event.h"
+#include "moon/events/event_queue.h"
 #include "platform/opengl/opengl_context.h"
 
 #include <GLFW/glfw3.h>
@@ -44,6 +45,17 @@ namespace moon
 
         context_->swap_buffers();
         glfwPollEvents();
+
+        // glfw callbacks only queue events; layers see them here, outside of glfwPollEvents
+        data_.events.drain(data_.event_callback);
+    }
+
+    void windows_window::wait_events(float timeout_seconds)
+    {
+        MOON_PROFILE_FUNCTION();
+
+        glfwWaitEventsTimeout((double)timeout_seconds);
+        data_.events.drain(data_.event_callback);
     }
 
     void windows_window::set_event_callback(const event_callback_fn& fn)
@@ -52,14 +64,27 @@ namespace moon
     }
 
     void windows_window::set_vsync(bool enabled)
+    {
+        set_vsync_mode(enabled ? vsync_mode::on : vsync_mode::off);
+    }
+
+    void windows_window::set_vsync_mode(vsync_mode mode)
     {
         MOON_PROFILE_FUNCTION();
 
-        if (enabled)
-            glfwSwapInterval(1);
-        else
-            glfwSwapInterval(0);
-        data_.vsync = enabled;
+        if (mode == vsync_mode::adaptive && !glfwExtensionSupported("WGL_EXT_swap_control_tear"))
+        {
+            MOON_CORE_WARN("Adaptive vsync isn't supported, falling back to vsync");
+            mode = vsync_mode::on;
+        }
+
+        switch (mode)
+        {
+        case vsync_mode::off:      glfwSwapInterval(0); break;
+        case vsync_mode::on:       glfwSwapInterval(1); break;
+        case vsync_mode::adaptive: glfwSwapInterval(-1); break;
+        }
+        data_.vsync = mode;
     }
 
     void windows_window::init(const window_props& props)
@@ -97,7 +122,7 @@ namespace moon
         context_->init();
 
         glfwSetWindowUserPointer(window_, &data_);
-        set_vsync(true);
+        set_vsync_mode(props.vsync);
 
         // glfw callbacks
         glfwSetWindowSizeCallback(window_, [](GLFWwindow* window, int width, int height)
@@ -105,22 +130,19 @@ namespace moon
             window_data* data = (window_data*)glfwGetWindowUserPointer(window);
             data->width = width;
             data->height = height;
-            window_resize_event event(width, height);
-            data->event_callback(event);
+            data->events.push(queued_event::make_window_resize((uint32_t)width, (uint32_t)height));
         });
 
         glfwSetWindowCloseCallback(window_, [](GLFWwindow* window)
         {
             window_data* data = (window_data*)glfwGetWindowUserPointer(window);
-            window_close_event event;
-            data->event_callback(event);
+            data->events.push(queued_event::make_window_close());
         });
 
         glfwSetCharCallback(window_, [](GLFWwindow* window, unsigned int keycode)
         {
             window_data* data = (window_data*)glfwGetWindowUserPointer(window);
-            key_typed_event event(keycode);
-            data->event_callback(event);
+            data->events.push(queued_event::make_key(event_type::KEY_TYPED, (int32_t)keycode));
         });
 
         glfwSetKeyCallback(window_, [](GLFWwindow* window, int key, int, int action, int)
@@ -130,20 +152,14 @@ namespace moon
             switch (action)
             {
             case GLFW_PRESS:
-            {
-                key_pressed_event event(key, 0);
-                data->event_callback(event);
-            } break;
+                data->events.push(queued_event::make_key(event_type::KEY_PRESSED, key, 0));
+                break;
             case GLFW_RELEASE:
-            {
-                key_released_event event(key);
-                data->event_callback(event);
-            } break;
+                data->events.push(queued_event::make_key(event_type::KEY_RELEASED, key));
+                break;
             case GLFW_REPEAT:
-            {
-                key_pressed_event event(key, 1);
-                data->event_callback(event);
-            } break;
+                data->events.push(queued_event::make_key(event_type::KEY_PRESSED, key, 1));
+                break;
             default:
                 MOON_CORE_ERROR("Unknown key action");
             }
@@ -156,15 +172,11 @@ namespace moon
             switch (action)
             {
             case GLFW_PRESS:
-            {
-                mouse_pressed_event event(button);
-                data->event_callback(event);
-            } break;
+                data->events.push(queued_event::make_mouse_button(event_type::MOUSE_BUTTON_PRESSED, button));
+                break;
             case GLFW_RELEASE:
-            {
-                mouse_released_event event(button);
-                data->event_callback(event);
-            } break;
+                data->events.push(queued_event::make_mouse_button(event_type::MOUSE_BUTTON_RELEASED, button));
+                break;
             default:
                 MOON_CORE_ERROR("Unknown mouse action");
             }
@@ -173,15 +185,13 @@ namespace moon
         glfwSetScrollCallback(window_, [](GLFWwindow* window, double xoffset, double yoffset)
         {
             window_data* data = (window_data*)glfwGetWindowUserPointer(window);
-            mouse_scrolled_event event((float)xoffset, (float)yoffset);
-            data->event_callback(event);
+            data->events.push(queued_event::make_mouse(event_type::MOUSE_SCROLLED, (float)xoffset, (float)yoffset));
         });
 
         glfwSetCursorPosCallback(window_, [](GLFWwindow* window, double xpos, double ypos)
         {
             window_data* data = (window_data*)glfwGetWindowUserPointer(window);
-            mouse_moved_event event((float)xpos, (float)ypos);
-            data->event_callback(event);
+            data->events.push(queued_event::make_mouse(event_type::MOUSE_MOVED_EVENT, (float)xpos, (float)ypos));
         });
     }
 
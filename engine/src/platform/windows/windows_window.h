@@ -1,6 +1,7 @@
 #pragma once
 
 #include "moon/core/window.h"
+#include "moon/events/event_queue.h"
 
 struct GLFWwindow;
 
@@ -13,6 +14,7 @@ namespace moon
         ~windows_window() override;
 
         void on_update() override;
+        void wait_events(float timeout_seconds) override;
 
         [[nodiscard]] uint32_t get_width() const override { return data_.width; }
         [[nodiscard]] uint32_t get_height() const override { return data_.height; }
@@ -20,7 +22,9 @@ namespace moon
         // window attributes
         void set_event_callback(const event_callback_fn& fn) override;
         void set_vsync(bool enabled) override;
-        [[nodiscard]] bool is_vsync() const override { return data_.vsync; }
+        [[nodiscard]] bool is_vsync() const override { return data_.vsync != vsync_mode::off; }
+        void set_vsync_mode(vsync_mode mode) override;
+        [[nodiscard]] vsync_mode get_vsync_mode() const override { return data_.vsync; }
 
         inline void* get_native_window() const override { return window_; }
 
@@ -35,9 +39,10 @@ namespace moon
             std::string title;
             uint32_t width;
             uint32_t height;
-            bool vsync;
+            vsync_mode vsync;
 
             event_callback_fn event_callback;
+            event_queue events;
         };
         window_data data_;
     };
@@ -0,0 +1,49 @@
+// batched circles, the quad is shaded with a signed distance to the unit circle
+
+#type vertex
+#version 460 core
+
+layout (location = 0) in vec3 a_WorldPosition;
+layout (location = 1) in vec3 a_LocalPosition;
+layout (location = 2) in vec4 a_Color;
+layout (location = 3) in float a_Thickness;
+layout (location = 4) in float a_Fade;
+
+#include "include/camera.glsl"
+
+out vec3 v_LocalPosition;
+out vec4 v_Color;
+out float v_Thickness;
+out float v_Fade;
+
+void main()
+{
+    v_LocalPosition = a_LocalPosition;
+    v_Color = a_Color;
+    v_Thickness = a_Thickness;
+    v_Fade = a_Fade;
+    gl_Position = u_VP * vec4(a_WorldPosition, 1.0);
+}
+
+#type fragment
+#version 460 core
+layout(location = 0) out vec4 FragColor;
+
+in vec3 v_LocalPosition;
+in vec4 v_Color;
+in float v_Thickness;
+in float v_Fade;
+
+void main()
+{
+    // 1 at the center, 0 on the rim
+    float distance = 1.0 - length(v_LocalPosition.xy);
+    float circle = smoothstep(0.0, v_Fade, distance);
+    circle *= 1.0 - smoothstep(v_Thickness, v_Thickness + v_Fade, distance);
+
+    if (circle == 0.0)
+        discard;
+
+    FragColor = v_Color;
+    FragColor.a *= circle;
+}
@@ -2,7 +2,7 @@
 #version 460 core
 layout (location = 0) in vec3 a_Position;
 
-uniform mat4 u_VP = mat4(1.0);
+#include "include/camera.glsl"
 uniform mat4 u_Model = mat4(1.0);
 
 out vec3 v_Pos;
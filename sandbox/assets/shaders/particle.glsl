@@ -0,0 +1,37 @@
+// instanced particles, the vertex shader expands each instance into a rotated square.
+// color is interpolated over the particle's life on the cpu
+
+#type vertex
+#version 460 core
+
+layout (location = 0) in vec2 a_Corner;
+layout (location = 1) in vec3 a_Position;
+layout (location = 2) in float a_Size;
+layout (location = 3) in float a_Rotation;
+layout (location = 4) in vec4 a_Color;
+
+#include "include/camera.glsl"
+
+out vec4 v_Color;
+
+void main()
+{
+    vec2 corner = a_Corner * a_Size;
+    float c = cos(a_Rotation);
+    float s = sin(a_Rotation);
+    vec2 offset = vec2(c * corner.x - s * corner.y, s * corner.x + c * corner.y);
+
+    v_Color = a_Color;
+    gl_Position = u_VP * vec4(a_Position.xy + offset, a_Position.z, 1.0);
+}
+
+#type fragment
+#version 460 core
+layout(location = 0) out vec4 FragColor;
+
+in vec4 v_Color;
+
+void main()
+{
+    FragColor = v_Color;
+}
@@ -0,0 +1,42 @@
+// batched sdf glyphs, the atlas is single channel and sampled with the distance in alpha
+
+#type vertex
+#version 460 core
+
+layout (location = 0) in vec3 a_Position;
+layout (location = 1) in vec4 a_Color;
+layout (location = 2) in vec2 a_TexCoord;
+
+#include "include/camera.glsl"
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+
+void main()
+{
+    v_Color = a_Color;
+    v_TexCoord = a_TexCoord;
+    gl_Position = u_VP * vec4(a_Position, 1.0);
+}
+
+#type fragment
+#version 460 core
+layout(location = 0) out vec4 FragColor;
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+
+uniform sampler2D u_FontAtlas;
+
+void main()
+{
+    // 0.5 is the glyph edge; smoothing over one screen pixel keeps it crisp at any scale
+    float distance = texture(u_FontAtlas, v_TexCoord).a;
+    float width = fwidth(distance);
+    float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+
+    if (alpha == 0.0)
+        discard;
+
+    FragColor = vec4(v_Color.rgb, v_Color.a * alpha);
+}
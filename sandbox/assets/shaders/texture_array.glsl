@@ -0,0 +1,42 @@
+// sprites stored as layers of one texture array; the texture index is the layer
+
+#type vertex
+#version 460 core
+
+layout (location = 0) in vec3 a_Position;
+layout (location = 1) in vec4 a_Color;
+layout (location = 2) in vec2 a_TexCoord;
+layout (location = 3) in float a_TexIndex;
+layout (location = 4) in float a_TilingFactor;
+
+#include "include/camera.glsl"
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+flat out float v_Layer;
+out float v_TilingFactor;
+
+void main()
+{
+    v_Color = a_Color;
+    v_TexCoord = a_TexCoord;
+    v_Layer = a_TexIndex;
+    v_TilingFactor = a_TilingFactor;
+    gl_Position = u_VP * vec4(a_Position, 1.0);
+}
+
+#type fragment
+#version 460 core
+layout(location = 0) out vec4 FragColor;
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+flat in float v_Layer;
+in float v_TilingFactor;
+
+uniform sampler2DArray u_TextureArray;
+
+void main()
+{
+    FragColor = v_Color * texture(u_TextureArray, vec3(v_TexCoord * v_TilingFactor, v_Layer));
+}
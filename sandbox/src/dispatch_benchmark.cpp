@@ -0,0 +1,101 @@
+#include "dispatch_benchmark.h"
+
+#include <imgui.h>
+
+#include <chrono>
+#include <functional>
+
+namespace
+{
+    /// event_dispatcher as it was before dispatch took its callable as a template parameter
+    class function_event_dispatcher
+    {
+        template<typename T>
+        using event_fn = std::function<bool(T&)>;
+
+    public:
+        explicit function_event_dispatcher(moon::event& event)
+            :
+            event_(event)
+        {}
+
+        template<typename T>
+        bool dispatch(event_fn<T> func)
+        {
+            if (event_.get_type() == T::get_static_type())
+            {
+                event_.handled = func(*(T*)&event_);
+                return true;
+            }
+            return false;
+        }
+    private:
+        moon::event& event_;
+    };
+
+    /// The chain application::on_event runs, with trivial handlers so the dispatch itself dominates
+    template<typename Dispatcher>
+    void dispatch_chain(moon::event& e, uint64_t& checksum)
+    {
+        Dispatcher dispatcher(e);
+        dispatcher.template dispatch<moon::window_close_event>([&](moon::window_close_event&) { checksum += 1; return false; });
+        dispatcher.template dispatch<moon::window_resize_event>([&](moon::window_resize_event& re) { checksum += re.get_width(); return false; });
+        dispatcher.template dispatch<moon::mouse_scrolled_event>([&](moon::mouse_scrolled_event& se) { checksum += (uint64_t)se.get_y_offset(); return false; });
+        dispatcher.template dispatch<moon::key_pressed_event>([&](moon::key_pressed_event& ke) { checksum += (uint64_t)ke.get_keycode(); return false; });
+    }
+}
+
+dispatch_benchmark_layer::dispatch_benchmark_layer()
+    :
+    layer("Dispatch Benchmark"),
+    events_ { &resize_event_, &scrolled_event_, &key_event_, &moved_event_ }
+{}
+
+void dispatch_benchmark_layer::on_attach()
+{
+    MOON_PROFILE_FUNCTION();
+
+    run();
+}
+
+void dispatch_benchmark_layer::run()
+{
+    MOON_PROFILE_FUNCTION();
+
+    const uint32_t count = (uint32_t)iterations_;
+    checksum_ = 0;
+
+    const auto time_ns = [&](auto&& body)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < count; i++)
+            body(*events_[i % event_kinds_]);
+        return std::chrono::duration<float, std::nano>(std::chrono::steady_clock::now() - start).count() / (float)count;
+    };
+
+    function_ns_ = time_ns([&](moon::event& e) { dispatch_chain<function_event_dispatcher>(e, checksum_); });
+    template_ns_ = time_ns([&](moon::event& e) { dispatch_chain<moon::event_dispatcher>(e, checksum_); });
+
+    MOON_INFO("Dispatch of {0} events: std::function {1:.2f} ns, template {2:.2f} ns per event", count, function_ns_, template_ns_);
+}
+
+void dispatch_benchmark_layer::on_imgui_render()
+{
+    MOON_PROFILE_FUNCTION();
+
+    if (!ImGui::GetCurrentContext())
+        ImGui::SetCurrentContext(moon_get_imgui_context());
+
+    ImGui::Begin("Dispatch Benchmark");
+
+    ImGui::SliderInt("Events", &iterations_, 1000, 10000000);
+    if (ImGui::Button("Run"))
+        run();
+
+    ImGui::Text("std::function: %.2f ns / event", function_ns_);
+    ImGui::Text("template: %.2f ns / event", template_ns_);
+    ImGui::Text("Speedup: %.2fx", template_ns_ > 0.0f ? function_ns_ / template_ns_ : 0.0f);
+    ImGui::Text("Checksum: %llu", (unsigned long long)checksum_);
+
+    ImGui::End();
+}
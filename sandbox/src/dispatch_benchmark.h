@@ -0,0 +1,36 @@
+#pragma once
+
+#include <moon.h>
+
+#include <array>
+
+/// Times event_dispatcher::dispatch against the std::function based dispatcher it replaced, with the same
+/// handler chain run over the same mixed stream of events
+class dispatch_benchmark_layer : public moon::layer
+{
+public:
+    dispatch_benchmark_layer();
+    ~dispatch_benchmark_layer() override = default;
+
+    void on_attach() override;
+    void on_imgui_render() override;
+
+private:
+    void run();
+
+private:
+    static constexpr uint32_t event_kinds_ = 4;
+
+    moon::window_resize_event resize_event_ { 1280, 720 };
+    moon::mouse_scrolled_event scrolled_event_ { 0.0f, 1.0f };
+    moon::key_pressed_event key_event_ { 32, 0 };
+    moon::mouse_moved_event moved_event_ { 10.0f, 20.0f };
+    std::array<moon::event*, event_kinds_> events_;
+
+    int32_t iterations_ = 1000000;
+
+    float function_ns_ = 0.0f;
+    float template_ns_ = 0.0f;
+    // summed by the handlers so neither loop can be optimized away
+    uint64_t checksum_ = 0;
+};
@@ -0,0 +1,115 @@
+#include "particle_benchmark.h"
+
+#include <imgui.h>
+
+#include <glm/gtc/constants.hpp>
+
+#include <chrono>
+#include <cmath>
+
+particle_benchmark_layer::particle_benchmark_layer()
+    :
+    layer("Particle Benchmark"),
+    camera_controller_(16.0f / 9.0f, true)
+{}
+
+void particle_benchmark_layer::on_attach()
+{
+    MOON_PROFILE_FUNCTION();
+
+    camera_controller_.set_zoom_level(12.0f);
+
+    particles_ = moon::create_scope<moon::particle_system>(max_particles_);
+    particles_->set_gravity({ 0.0f, -2.0f });
+
+    for (uint32_t i = 0; i < emitter_count_; i++)
+    {
+        const float angle = (float)i / (float)emitter_count_ * 2.0f * glm::pi<float>();
+        const glm::vec2 direction = { std::cos(angle), std::sin(angle) };
+
+        moon::particle_props props;
+        props.position = direction * 6.0f;
+        props.velocity = direction * 3.0f;
+        props.velocity_variation = { 4.0f, 4.0f };
+        props.color_begin = { 1.0f, 0.5f + 0.5f * direction.x, 0.2f, 1.0f };
+        props.color_end = { 0.2f, 0.3f, 1.0f, 0.0f };
+        props.size_begin = 0.08f;
+        props.size_end = 0.01f;
+        props.size_variation = 0.04f;
+        props.angular_velocity = 4.0f;
+        props.life_time = life_time_;
+
+        emitters_.push_back(particles_->create_emitter(props, 0.0f));
+    }
+
+    update_emitter_rates();
+}
+
+void particle_benchmark_layer::on_detach()
+{
+    MOON_PROFILE_FUNCTION();
+
+    emitters_.clear();
+    particles_.reset();
+}
+
+void particle_benchmark_layer::update_emitter_rates()
+{
+    // emitted at rate r and living life_time seconds, the pool settles at r * life_time particles
+    const float rate = (float)target_particles_ / life_time_ / (float)emitter_count_;
+    for (const moon::particle_emitter_handle handle : emitters_)
+    {
+        if (moon::particle_emitter* emitter = particles_->get_emitter(handle))
+            emitter->rate = rate;
+    }
+}
+
+void particle_benchmark_layer::on_update(moon::timestep ts)
+{
+    MOON_PROFILE_FUNCTION();
+
+    frame_ms_ = ts.get_milliseconds();
+    camera_controller_.on_update(ts);
+
+    particles_->on_update(ts);
+
+    moon::renderer2d::reset_stats();
+    moon::render_command::set_clear_color({ 0.05f, 0.05f, 0.07f, 1.0f });
+    moon::render_command::clear();
+
+    const auto start = std::chrono::steady_clock::now();
+    moon::renderer2d::begin_scene(camera_controller_.get_camera());
+    if (render_particles_)
+        particles_->on_render();
+    moon::renderer2d::end_scene();
+    draw_ms_ = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void particle_benchmark_layer::on_imgui_render()
+{
+    MOON_PROFILE_FUNCTION();
+
+    if (!ImGui::GetCurrentContext())
+        ImGui::SetCurrentContext(moon_get_imgui_context());
+
+    ImGui::Begin("Particle Benchmark");
+
+    if (ImGui::SliderInt("Target Particles", &target_particles_, 0, (int32_t)max_particles_))
+        update_emitter_rates();
+    ImGui::Checkbox("Render", &render_particles_);
+
+    const moon::particle_system_stats& stats = particles_->get_stats();
+    ImGui::Text("Live: %u / %u", stats.live_particles, stats.capacity);
+    ImGui::Text("Emitted: %u, Dropped: %u", stats.emitted, stats.dropped);
+    ImGui::Text("Update: %.2f ms", stats.update_ms);
+    ImGui::Text("Draw: %.2f ms", draw_ms_);
+    ImGui::Text("Frame: %.2f ms (%.0f fps)", frame_ms_, frame_ms_ > 0.0f ? 1000.0f / frame_ms_ : 0.0f);
+    ImGui::Text("Draw Calls: %d", moon::renderer2d::get_stats().draw_calls);
+
+    ImGui::End();
+}
+
+void particle_benchmark_layer::on_event(moon::event& e)
+{
+    camera_controller_.on_event(e);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <moon.h>
+
+/// Stress scene for the particle system: emitters on a ring keep the pool near a target particle count,
+/// and the panel reports update and draw times separately
+class particle_benchmark_layer : public moon::layer
+{
+public:
+    particle_benchmark_layer();
+    ~particle_benchmark_layer() override = default;
+
+    void on_attach() override;
+    void on_detach() override;
+    void on_update(moon::timestep ts) override;
+    void on_imgui_render() override;
+    void on_event(moon::event& e) override;
+
+private:
+    void update_emitter_rates();
+
+private:
+    static constexpr uint32_t max_particles_ = 1000000;
+    static constexpr uint32_t emitter_count_ = 16;
+    static constexpr float life_time_ = 2.0f;
+
+    moon::scope<moon::particle_system> particles_;
+    std::vector<moon::particle_emitter_handle> emitters_;
+
+    int32_t target_particles_ = 1000000;
+    bool render_particles_ = true;
+
+    float frame_ms_ = 0.0f;
+    float draw_ms_ = 0.0f;
+
+    moon::orthographic_camera_controller camera_controller_;
+};
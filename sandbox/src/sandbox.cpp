@@ -12,6 +12,8 @@
 #include <platform/opengl/opengl_shader.h>
 
 #include "sandbox2d.h"
+#include "particle_benchmark.h"
+#include "dispatch_benchmark.h"
 
 class sandbox_layer : public moon::layer
 {
@@ -46,7 +48,14 @@ public:
             layout (location = 0) in vec3 a_Position;
             layout (location = 1) in vec4 a_Color;
 
-            uniform mat4 u_VP = mat4(1.0);
+            layout(std140, binding = 0) uniform Camera
+            {
+                mat4 u_View;
+                mat4 u_Projection;
+                mat4 u_VP;
+                vec4 u_Viewport;
+                float u_Time;
+            };
             uniform mat4 u_Model = mat4(1.0);
 
             out vec4 v_Color;
@@ -92,7 +101,14 @@ public:
             #version 460 core
             layout (location = 0) in vec3 a_Pos;
 
-            uniform mat4 u_VP = mat4(1.0);
+            layout(std140, binding = 0) uniform Camera
+            {
+                mat4 u_View;
+                mat4 u_Projection;
+                mat4 u_VP;
+                vec4 u_Viewport;
+                float u_Time;
+            };
             uniform mat4 u_Model = mat4(1.0);
 
             void main()
@@ -200,6 +216,8 @@ public:
         MOON_INFO("sandbox app created");
         //push_layer(new sandbox_layer());
         push_layer(new sandbox2d_layer());
+        //push_layer(new particle_benchmark_layer());
+        //push_layer(new dispatch_benchmark_layer());
     }
 
 };
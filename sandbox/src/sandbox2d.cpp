@@ -77,6 +77,10 @@ void sandbox2d_layer::on_imgui_render()
     ImGui::Text("Renderer2D Stats:");
     ImGui::Text("Draw Calls: %d", stats.draw_calls);
     ImGui::Text("Quads: %d", stats.quad_count);
+    ImGui::Text("Circles: %d", stats.circle_count);
+    ImGui::Text("Lines: %d", stats.line_count);
+    ImGui::Text("Glyphs: %d", stats.glyph_count);
+    ImGui::Text("Particles: %d", stats.particle_count);
     ImGui::Text("Vertices: %d", stats.get_total_vertex_count());
     ImGui::Text("Indices: %d", stats.get_total_index_count());
 